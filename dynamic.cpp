@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 #include "dynamic.hpp"
 
 namespace dynamic
@@ -46,28 +50,212 @@ std::ostream& operator<<(std::ostream& o, ID const& id)
     return o << id.toString();
 }
 
+//=============================================================================
+// MapKey implementations
+//=============================================================================
+
+MapKey::MapKey(std::string_view key)
+    : hashValue(hashOf(key)), length(static_cast<std::uint32_t>(key.size()))
+{
+    assert(key.size() <= std::numeric_limits<std::uint32_t>::max());
+
+    if (isInline())
+    {
+        std::memcpy(storage.chars, key.data(), key.size());
+    }
+    else
+    {
+        storage.heap = new char[key.size()];
+        std::memcpy(storage.heap, key.data(), key.size());
+    }
+}
+
+MapKey::MapKey(MapKey const& o) : hashValue(o.hashValue), length(o.length), storage(o.storage)
+{
+    if (! isInline())
+    {
+        storage.heap = new char[length];
+        std::memcpy(storage.heap, o.storage.heap, length);
+    }
+}
+
+MapKey::MapKey(MapKey&& o) noexcept : hashValue(o.hashValue), length(o.length), storage(o.storage)
+{
+    o.hashValue = hashOf({});
+    o.length = 0;
+    o.storage = {};
+}
+
+MapKey::~MapKey()
+{
+    if (! isInline())
+        delete[] storage.heap;
+}
+
+MapKey& MapKey::operator=(MapKey const& o)
+{
+    if (this != &o)
+        *this = MapKey(o);
+
+    return *this;
+}
+
+MapKey& MapKey::operator=(MapKey&& o) noexcept
+{
+    if (this != &o)
+    {
+        if (! isInline())
+            delete[] storage.heap;
+
+        hashValue = std::exchange(o.hashValue, hashOf({}));
+        length = std::exchange(o.length, 0);
+        storage = std::exchange(o.storage, {});
+    }
+
+    return *this;
+}
+
+bool operator==(MapKey const& a, MapKey const& b)
+{
+    if (a.hashValue != b.hashValue || a.length != b.length)
+        return false;
+
+    // inline storage is zero padded, so this is a fixed-size word compare
+    if (a.isInline())
+        return std::memcmp(a.storage.chars, b.storage.chars, sizeof(a.storage.chars)) == 0;
+
+    return std::memcmp(a.storage.heap, b.storage.heap, a.length) == 0;
+}
+
+//=============================================================================
+// MemoryResourceScope implementations
+//=============================================================================
+thread_local std::pmr::memory_resource* MemoryResourceScope::active = nullptr;
+
+MemoryResourceScope::MemoryResourceScope(std::pmr::memory_resource* resource)
+    : previous(std::exchange(active, resource))
+{}
+
+MemoryResourceScope::~MemoryResourceScope()
+{
+    active = previous;
+}
+
+std::pmr::memory_resource* MemoryResourceScope::current()
+{
+    return active != nullptr ? active : std::pmr::get_default_resource();
+}
+
+//=============================================================================
+// MetaTypeRegistry implementations
+//=============================================================================
+namespace
+{
+struct StringHash
+{
+    using is_transparent = void;
+    std::size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+};
+
+struct Registry
+{
+    std::shared_mutex mutex;
+    std::unordered_map<std::string, MetaType const*, StringHash, std::equal_to<>> byName;
+    std::unordered_map<std::uint64_t, MetaType const*> bySchemaHash;
+    std::vector<MetaType const*> all;
+};
+
+// function-local static: records register themselves during static initialization of other TUs
+Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+} // namespace
+
+void MetaTypeRegistry::add(MetaType const& meta)
+{
+    auto& reg = registry();
+    std::unique_lock lock(reg.mutex);
+
+    auto const [_, isNewName] = reg.byName.try_emplace(std::string(meta.name()), &meta);
+    auto const [__, isNewHash] = reg.bySchemaHash.try_emplace(meta.schemaHash(), &meta);
+
+    if (isNewName || isNewHash)
+        reg.all.push_back(&meta);
+}
+
+MetaType const* MetaTypeRegistry::findByName(std::string_view name)
+{
+    auto& reg = registry();
+    std::shared_lock lock(reg.mutex);
+
+    auto const it = reg.byName.find(name);
+    return it != reg.byName.end() ? it->second : nullptr;
+}
+
+MetaType const* MetaTypeRegistry::findBySchemaHash(std::uint64_t hash)
+{
+    auto& reg = registry();
+    std::shared_lock lock(reg.mutex);
+
+    auto const it = reg.bySchemaHash.find(hash);
+    return it != reg.bySchemaHash.end() ? it->second : nullptr;
+}
+
+std::vector<MetaType const*> MetaTypeRegistry::registered()
+{
+    auto& reg = registry();
+    std::shared_lock lock(reg.mutex);
+    return reg.all;
+}
+
 //=============================================================================
 // Value implementations
 //=============================================================================
-thread_local std::size_t Value::recursiveListenerDisabler = 0;
 
-Value::Value(Value const&) : parent(nullptr) {}
+Value::Value(Value const& o) : parent(nullptr), typeIndex(o.typeIndex) {}
 
-Value::Value(Value&& o) : parent(nullptr)
+Value::Value(Value&& o) : parent(nullptr), typeIndex(o.typeIndex)
 {
     std::swap(parent, o.parent);
 }
 
-typename Value::TypesVariant Value::visit_helper()
+thread_local Value const* Value::assignedRecord = nullptr;
+
+bool Value::markChanged() const
+{
+    // the walk which stamps the ancestors also tells whether one of them has field hooks
+    auto hooked = false;
+
+    if (isStruct())
+        lastChangedVersion = static_cast<Object const*>(this)->stampSubtree(false, hooked);
+    else if (parent != nullptr)
+    {
+        hooked = parent->fieldHooks != nullptr;
+        lastChangedVersion = parent->stampSubtree(false, hooked);
+    }
+    else
+        ++lastChangedVersion;
+
+    return hooked;
+}
+
+bool Value::isInAssignedRecord() const
 {
-    assert(false); /* crash! */
-    return *reinterpret_cast<TypesVariant*>(1);
+    // fast path: this thread does not assign a record
+    if (auto const* assigned = assignedRecord; assigned != nullptr)
+        for (auto const* ancestor = parent; ancestor != nullptr; ancestor = ancestor->parent)
+            if (ancestor == assigned)
+                return true;
+
+    return false;
 }
 
-typename Value::ConstTypesVariant Value::visit_helper() const
+void Value::runFieldHooks(bool hooked, bool ownHooksRan)
 {
-    assert(false); /* crash! */
-    return *reinterpret_cast<ConstTypesVariant*>(1);
+    if (hooked)
+        Object::runFieldHooksAbove(*this, ownHooksRan);
 }
 
 Value& Value::operator=(Value const& other)
@@ -90,22 +278,173 @@ Invalid& Value::kInvalid = std::invoke([] () -> auto&&
 // Object implementations
 //=============================================================================
 Object::Object(Object const& o) : Value(o) {}
-Object::Object(Object&& o) : Value(std::move(o)), childListeners(std::move(o.childListeners)) {}
+Object::Object(Object&& o)
+    : Value(std::move(o)),
+      childListeners(std::move(o.childListeners)),
+      pathFreeChildListeners(std::move(o.pathFreeChildListeners)),
+      coalesced(o.coalesced.exchange(nullptr))
+{}
 
-void Object::callChildListeners(ID const& id, Operation op, Object const& parentOfChangedValue, Value const& newValue) const
+Object::~Object()
 {
-    std::erase_if(childListeners, [] (auto const& p) { return p.first.expired(); });
+    delete coalesced.load();
+}
+
+void Object::runFieldHooksAbove(Value& changed, bool ownHooksRan)
+{
+    auto* child = &changed;
 
-    for (auto& [token, listener] : childListeners)
+    for (auto* object = changed.parent; object != nullptr; child = object, object = object->parent)
     {
-        // we need to check if the token expired again, becaus other listeners may have caused it to be expired
-        if (token.expired())
-            continue;
+        if (object->fieldHooks != nullptr)
+            object->fieldHooks->changed(*object, *child, ownHooksRan && child == &changed);
+
+        // the writers of all shards share the ancestors of a shard: only lock them if one of them has hooks
+        if (object->sharedAncestorsMutex != nullptr && object->parent != nullptr)
+        {
+            for (auto const* ancestor = object->parent; ancestor != nullptr; ancestor = ancestor->parent)
+            {
+                if (ancestor->fieldHooks != nullptr)
+                {
+                    std::lock_guard lock(*object->sharedAncestorsMutex);
+                    runFieldHooksAbove(*object, false);
+                    break;
+                }
+            }
+
+            return;
+        }
+    }
+}
+
+std::uint64_t Object::stampSubtree(bool shared, bool& hooked) const
+{
+    contentHashValid.store(false, std::memory_order_relaxed);
 
-        listener(id, op, parentOfChangedValue, newValue);
+    if (parent == nullptr)
+    {
+        // the root's subtree version is the last version handed out in this tree
+        if (shared)
+            return lastSubtreeVersion.fetch_add(1, std::memory_order_relaxed) + 1;
+
+        auto const version = lastSubtreeVersion.load(std::memory_order_relaxed) + 1;
+        lastSubtreeVersion.store(version, std::memory_order_relaxed);
+        return version;
     }
 
-    if (parent != nullptr)
+    hooked = hooked || parent->fieldHooks != nullptr;
+    auto const version = parent->stampSubtree(shared || sharedAncestorsMutex != nullptr, hooked);
+
+    if (shared)
+    {
+        // the writer of another shard may have raised the version past ours already
+        auto current = lastSubtreeVersion.load(std::memory_order_relaxed);
+        while (current < version && ! lastSubtreeVersion.compare_exchange_weak(current, version, std::memory_order_relaxed)) {}
+    }
+    else
+    {
+        lastSubtreeVersion.store(version, std::memory_order_relaxed);
+    }
+
+    return version;
+}
+
+Object::ChildListenerKinds Object::propagateChildChange() const
+{
+    ChildListenerKinds kinds;
+    std::optional<Clock::time_point> now;
+
+    // once the walk passed a shard, the ancestors are shared by the writers of all shards
+    std::mutex* shared = nullptr;
+
+    for (auto const* object = this; object != nullptr; object = object->parent)
+    {
+        object->childChanged();
+
+        if (auto const* list = object->coalesced.load(std::memory_order_acquire))
+        {
+            auto const next = list->nextDelivery.load(std::memory_order_relaxed);
+
+            // only read the clock if a coalesced listener may be due
+            if (next != std::numeric_limits<Clock::rep>::max())
+            {
+                if (! now)
+                    now = Clock::now();
+
+                if (now->time_since_epoch().count() >= next)
+                {
+                    std::unique_lock<std::mutex> lock;
+
+                    if (shared != nullptr)
+                        lock = std::unique_lock(*shared);
+
+                    object->deliverCoalescedChildListeners(*now, false);
+                }
+            }
+        }
+
+        kinds.withPath = kinds.withPath || ! object->childListeners.empty();
+        kinds.pathFree = kinds.pathFree || ! object->pathFreeChildListeners.empty();
+
+        if (object->sharedAncestorsMutex != nullptr)
+            shared = object->sharedAncestorsMutex;
+    }
+
+    return kinds;
+}
+
+Object::CoalescedChildListeners& Object::coalescedChildListeners() const
+{
+    if (auto* existing = coalesced.load(std::memory_order_acquire))
+        return *existing;
+
+    auto created = std::make_unique<CoalescedChildListeners>();
+    CoalescedChildListeners* expected = nullptr;
+
+    // another thread may have created the list in the meantime
+    if (coalesced.compare_exchange_strong(expected, created.get(), std::memory_order_acq_rel))
+        return *created.release();
+
+    return *expected;
+}
+
+void Object::deliverCoalescedChildListeners(Clock::time_point now, bool flush) const
+{
+    auto& list = *coalesced.load(std::memory_order_acquire);
+    auto next = Clock::time_point::max();
+
+    list.listeners.forEach([this, now, flush, &next] (CoalescedListenerFunction const& deliver)
+    {
+        next = std::min(next, deliver(*this, now, flush));
+    });
+
+    list.nextDelivery.store(next.time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+void Object::flushCoalescedChildListeners() const
+{
+    if (coalesced.load(std::memory_order_acquire) != nullptr)
+        deliverCoalescedChildListeners(Clock::now(), true);
+}
+
+void Object::callChildListeners(ID const& id, Operation op, Object const& parentOfChangedValue, Value const& newValue) const
+{
+    childListeners.call(id, op, parentOfChangedValue, newValue);
+
+    if (parent != nullptr && sharedAncestorsMutex != nullptr)
+    {
+        // a shard stands in for its ConcurrentMap: only lock the shared ancestors if one of them listens
+        for (auto const* ancestor = parent; ancestor != nullptr; ancestor = ancestor->parent)
+        {
+            if (! ancestor->childListeners.empty())
+            {
+                std::lock_guard lock(*sharedAncestorsMutex);
+                parent->callChildListeners(id, op, &parentOfChangedValue == this ? *parent : parentOfChangedValue, newValue);
+                break;
+            }
+        }
+    }
+    else if (parent != nullptr)
     {
         auto newID = id;
         newID.insert(newID.begin(), std::string(this->fieldname()));
@@ -113,6 +452,168 @@ void Object::callChildListeners(ID const& id, Operation op, Object const& parent
     }
 }
 
+void Object::notifyChildChange(ChildListenerKinds kinds, std::string const& name, Operation op, Value const& newValue) const
+{
+    if (kinds.pathFree)
+        callPathFreeChildListeners(name, op, *this, newValue);
+
+    if (kinds.withPath)
+        callChildListeners(std::vector<std::string>(1, name), op, *this, newValue);
+}
+
+void Object::callPathFreeChildListeners(std::string_view name, Operation op, Object const& parentOfChangedValue, Value const& newValue) const
+{
+    pathFreeChildListeners.call(parentOfChangedValue, name, op, newValue);
+
+    if (parent != nullptr && sharedAncestorsMutex != nullptr)
+    {
+        // a shard stands in for its ConcurrentMap: only lock the shared ancestors if one of them listens
+        for (auto const* ancestor = parent; ancestor != nullptr; ancestor = ancestor->parent)
+        {
+            if (! ancestor->pathFreeChildListeners.empty())
+            {
+                std::lock_guard lock(*sharedAncestorsMutex);
+                parent->callPathFreeChildListeners(name, op, &parentOfChangedValue == this ? *parent : parentOfChangedValue, newValue);
+                break;
+            }
+        }
+    }
+    else if (parent != nullptr)
+    {
+        parent->callPathFreeChildListeners(name, op, parentOfChangedValue, newValue);
+    }
+}
+
+ID Object::pathTo(Object const& descendant, std::string_view name) const
+{
+    ID path;
+    path.emplace_back(name);
+
+    // shards are not part of paths
+    for (auto const* object = &descendant; object != nullptr && object != this; object = object->parent)
+        if (object->sharedAncestorsMutex == nullptr)
+            path.insert(path.begin(), object->fieldname());
+
+    return path;
+}
+
+bool Object::isPathTo(ID const& path, Object const& descendant, std::string_view name) const
+{
+    if (path.empty() || path.back() != name)
+        return false;
+
+    auto remaining = path.size() - 1;
+
+    for (auto const* object = &descendant; object != this; object = object->parent)
+    {
+        if (object == nullptr)
+            return false;
+
+        if (object->sharedAncestorsMutex != nullptr)
+            continue;
+
+        if (remaining == 0 || path[--remaining] != object->fieldname())
+            return false;
+    }
+
+    return remaining == 0;
+}
+
+std::size_t Object::compact()
+{
+    std::size_t released = 0;
+
+    for (auto& child : fieldRange())
+        if (child.isStruct())
+            released += static_cast<Object&>(child).compact();
+
+    return released;
+}
+
+void Object::copyVersionsFrom(Value const& o)
+{
+    Value::copyVersionsFrom(o);
+
+    auto const& other = static_cast<Object const&>(o);
+    lastSubtreeVersion.store(other.subtreeVersion(), std::memory_order_relaxed);
+
+    // unloaded children were never stamped
+    if (subtreeVersion() == 0 || hasUnloadedChildren() || other.hasUnloadedChildren())
+        return;
+
+    auto const n = fieldCount();
+    assert(n == other.fieldCount());
+
+    for (std::size_t idx = 0; idx < std::min(n, other.fieldCount()); ++idx)
+        fieldAt(idx).copyVersionsFrom(other.fieldAt(idx));
+}
+
+ChangedValueRange Object::changedSince(std::uint64_t version) const
+{
+    return ChangedValueRange(*this, version);
+}
+
+//=============================================================================
+// ChangedValueRange implementations
+//=============================================================================
+ChangedValueRange::iterator::iterator(Object const& root, std::uint64_t since_) : since(since_)
+{
+    if (root.subtreeVersion() > since)
+        stack.push_back({ &root, root.fieldCount() });
+
+    advance();
+}
+
+void ChangedValueRange::iterator::advance()
+{
+    // descend into the value visited last if anything below it changed
+    if (current != nullptr)
+    {
+        if (current->isStruct() && static_cast<Object const*>(current)->subtreeVersion() > since)
+        {
+            auto const* object = static_cast<Object const*>(current);
+            stack.push_back({ object, object->fieldCount() });
+        }
+        else
+            path.pop_back();
+
+        current = nullptr;
+    }
+
+    while (! stack.empty())
+    {
+        auto& frame = stack.back();
+
+        if (frame.next == frame.count)
+        {
+            stack.pop_back();
+
+            // the root's frame has no path element
+            if (! path.empty())
+                path.pop_back();
+
+            continue;
+        }
+
+        auto const& child = frame.object->fieldAt(frame.next++);
+        auto const subtreeChanged = child.isStruct() && static_cast<Object const&>(child).subtreeVersion() > since;
+
+        if (child.version() <= since && ! subtreeChanged)
+            continue;
+
+        path.push_back(child.fieldname());
+
+        if (child.version() > since)
+        {
+            current = &child;
+            return;
+        }
+
+        auto const& object = static_cast<Object const&>(child);
+        stack.push_back({ &object, object.fieldCount() });
+    }
+}
+
 Object& Object::operator=(Object const& o)
 {
     Value::operator=(static_cast<Value const&>(o));
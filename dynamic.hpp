@@ -35,14 +35,88 @@
 #include <iostream>
 #include <cassert>
 #include <cstddef>
+#include <cstring>
+#include <limits>
 #include <iterator>
 #include <span>
 #include <utility>
-#include <variant>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <functional>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <vector>
 #include "fixed_string.hpp"
 #include "CxxUtilities.hpp"
 #include "dynamic_detail.hpp"
 
+namespace dynamic
+{
+/**
+ * @brief Registration point for additional fundamental (leaf) types
+ *
+ * By default, only the types listed in Value's built-in type list can be used
+ * as leaves. Specialize this trait to register further types, which then work
+ * with Field<>, visit(), MetaType and the stream/format operators exactly like
+ * the built-in ones - no string round-trips are needed:
+ *
+ * @code
+ * // my_leaf_types.hpp
+ * #include <chrono>
+ * template <>
+ * struct dynamic::ExtraFundamentalTypes<>
+ * {
+ *     using Types = std::tuple<std::chrono::nanoseconds, std::array<char, 16>>;
+ * };
+ * @endcode
+ *
+ * The specialization must be seen by every translation unit (including
+ * dynamic.cpp) before anything is instantiated, so it lives in its own header
+ * which dynamic.hpp includes when DYNAMIC_EXTRA_FUNDAMENTAL_TYPES_HEADER is
+ * defined, e.g. -DDYNAMIC_EXTRA_FUNDAMENTAL_TYPES_HEADER="\"my_leaf_types.hpp\"".
+ *
+ * Registered types must be default constructible and copyable. operator== is
+ * used for change detection if available (otherwise every assignment counts as
+ * a change), operator<< and std::formatter are used for output if available.
+ */
+template <typename>
+struct ExtraFundamentalTypes
+{
+    using Types = std::tuple<>;
+};
+
+/**
+ * @brief Opt-in for reading leaves of type T from other threads
+ *
+ * If true, Fundamental<T>::load() can be called from any number of threads
+ * while a single thread changes the value through set(), mutate(), assign() or
+ * a mutable visit(). Readers never block the writer and never observe a torn
+ * value. Leaves of up to machine word size (more precisely: types for which
+ * std::atomic_ref<T> is always lock-free) are written with atomic stores, which
+ * compile to plain stores on common platforms. Wider types are guarded by a
+ * sequence lock, which adds a counter to every leaf of that type. Arithmetic
+ * and enum types of up to 8 bytes are enabled by default, other types need to
+ * opt in explicitly:
+ *
+ * @code
+ * template <> struct dynamic::ConcurrentReads<Quote> : std::true_type {};
+ * @endcode
+ *
+ * T must be trivially copyable. Listener semantics are unchanged: listeners
+ * still run synchronously on the writer's thread.
+ */
+template <typename T>
+struct ConcurrentReads : std::bool_constant<(std::is_arithmetic_v<T> || std::is_enum_v<T>) && sizeof(T) <= sizeof(std::uint64_t)> {};
+} // namespace dynamic
+
+#ifdef DYNAMIC_EXTRA_FUNDAMENTAL_TYPES_HEADER
+ #include DYNAMIC_EXTRA_FUNDAMENTAL_TYPES_HEADER
+#endif
+
 namespace dynamic
 {
 
@@ -92,6 +166,80 @@ struct ID : std::vector<std::string>
     static ID fromString(std::string const& path);
 };
 
+/**
+ * @brief Key of a Map<T> element
+ *
+ * Keys of up to kInlineCapacity characters are stored inline (zero padded) so
+ * that creating a key does not allocate; longer keys fall back to the heap.
+ * The FNV-1a hash of the key is computed once on construction, so comparing
+ * two keys is a hash compare followed by a fixed-size word compare of the
+ * inline storage.
+ *
+ * Map lookups taking a std::string_view hash the probe once and then compare
+ * hashes before characters. Keep a MapKey around to avoid even that.
+ */
+class MapKey
+{
+public:
+    /// Maximum number of characters stored without a heap allocation
+    static constexpr std::size_t kInlineCapacity = 15;
+
+    /// Default constructor - empty key
+    MapKey() = default;
+
+    /// Construct from a string (allocates only if key is longer than kInlineCapacity)
+    explicit MapKey(std::string_view key);
+
+    /// Copy constructor
+    MapKey(MapKey const& o);
+
+    /// Move constructor
+    MapKey(MapKey&& o) noexcept;
+
+    /// Destructor
+    ~MapKey();
+
+    /// Copy assignment operator
+    MapKey& operator=(MapKey const& o);
+
+    /// Move assignment operator
+    MapKey& operator=(MapKey&& o) noexcept;
+
+    /// Returns the characters of the key
+    std::string_view view() const { return { isInline() ? storage.chars : storage.heap, length }; }
+
+    /// Implicit conversion to std::string_view
+    operator std::string_view() const { return view(); }
+
+    /// Returns the precomputed hash of the key (same as hashOf(view()))
+    std::size_t hash() const { return hashValue; }
+
+    /// Returns the number of characters in the key
+    std::size_t size() const { return length; }
+
+    /// Returns true if the key is stored without a heap allocation
+    bool isInline() const { return length <= kInlineCapacity; }
+
+    /// Returns true if this key equals key whose hash is keyHash
+    bool matches(std::size_t keyHash, std::string_view key) const { return hashValue == keyHash && view() == key; }
+
+    /// FNV-1a hash used for all keys
+    static constexpr std::size_t hashOf(std::string_view key) { return static_cast<std::size_t>(detail::fnv1a(key)); }
+
+    friend bool operator==(MapKey const& a, MapKey const& b);
+
+private:
+    union Storage
+    {
+        char chars[kInlineCapacity + 1];
+        char* heap;
+    };
+
+    std::size_t hashValue = hashOf({});
+    std::uint32_t length = 0;
+    Storage storage = {};
+};
+
 /**
  * @brief Compile-time string wrapper for use with the "_fld" literal
  *
@@ -116,24 +264,54 @@ template <typename T> class Array;
 template <typename T> class Map;
 
 // Forward declaration of Field (needed by detail namespace utilities)
-template <typename T, fixstr::fixed_string Name> class Field;
+template <typename T, fixstr::fixed_string Name, typename Hooks> class Field;
+template <typename T, fixstr::fixed_string Name, typename Function, fixstr::fixed_string... Dependencies> class Computed;
 
 // Forward declarations for MetaType system
 class MetaType;
 
+class ChangedValueRange;
+class LeafPath;
+template <typename ObjectType> class FieldRange;
+
 /**
  * @brief Describes a single field within a Record's MetaType
  *
  * Provides the field name and a function pointer to lazily obtain the
  * MetaType of the field's underlying type, avoiding static initialization
  * order issues with recursive/nested types.
+ *
+ * The remaining members allow generic code to access fields of a struct
+ * through a raw pointer to it, without an Object instance. All object
+ * pointers point to the plain struct T (e.g. record.operator->()), not
+ * to a Record<T>.
  */
 struct FieldDescriptor
 {
     std::string_view fieldname;
     MetaType const& (*metaType)();
+
+    /// Byte offset of the Field<> member within the struct, measured once at runtime on a static default constructed instance
+    std::size_t offset;
+
+    /// Size in bytes of the field's value type, i.e. of the objects copied by get and set
+    std::size_t size;
+
+    /// Returns the Field<> member of the struct at object
+    Value& (*field)(void* object);
+
+    /// Returns the Field<> member of the struct at object (const version)
+    Value const& (*constField)(void const* object);
+
+    /// Copies the field's value into out, which must point to a constructed value of the field's type
+    void (*get)(void const* object, void* out);
+
+    /// Assigns the value at in to the field (listeners are notified as with Field::operator=)
+    void (*set)(void* object, void const* in);
 };
 
+namespace detail { template <typename Function> class ListenerList; }
+
 /**
  * @brief RAII token for managing listener lifetime
  *
@@ -173,11 +351,8 @@ public:
     ListenerToken& operator=(ListenerToken const&) = delete;
 
 private:
-    template <typename> friend class Fundamental;
-    template <typename> friend class Array;
-    template <typename> friend class Map;
-    friend class Object;
-    
+    template <typename> friend class detail::ListenerList;
+
     struct private_constructor_t {};
 
     struct Impl {};
@@ -186,6 +361,128 @@ private:
     std::shared_ptr<Impl> token;
 };
 
+namespace detail
+{
+/**
+ * @brief Listener registry which may be changed from any thread, even during dispatch
+ *
+ * The listeners are kept in an immutable array which add() replaces as a whole
+ * (copy-on-write). call() reads the current array with a single atomic load and
+ * takes no locks; only registrations are serialized by a mutex. Arrays replaced
+ * while a dispatch may still read them are retired, and freed by the last
+ * dispatch to finish or by a later add(), whichever first sees no dispatch in
+ * flight.
+ *
+ * A listener is removed by destroying its token, from any thread. call() skips
+ * listeners whose token expired and never modifies the list: expired entries
+ * are pruned when the next add() copies the array.
+ */
+template <typename Function>
+class ListenerList
+{
+public:
+    ListenerList() = default;
+    ListenerList(ListenerList&& o) noexcept;
+    ~ListenerList();
+
+    ListenerList(ListenerList const&) = delete;
+    ListenerList& operator=(ListenerList const&) = delete;
+
+    /// Adds a listener which is called until the returned token is destroyed
+    ListenerToken add(Function function);
+
+    /// Adds a listener which is called until context expires
+    void add(std::weak_ptr<void> context, Function function);
+
+    /// Adds a listener which is called until alive() returns false (checked under the registration mutex)
+    void addWhile(std::function<bool()> alive, Function function);
+
+    /// Calls every listener whose token has not expired
+    template <typename... Args>
+    void call(Args const&... args) const;
+
+    /// Calls visitor(Function const&) for every listener whose token has not expired
+    template <typename Visitor>
+    void forEach(Visitor && visitor) const;
+
+    /// True if no listener was added since the last one was pruned (expired listeners may still count)
+    bool empty() const { return count.load(std::memory_order_acquire) == 0; }
+
+private:
+    struct Entry
+    {
+        std::weak_ptr<ListenerToken::Impl> token;
+        std::shared_ptr<Function const> function;
+    };
+
+    using Entries = std::vector<Entry>;
+
+    /// Binds a listener token to a context: the token is destroyed once the context is gone
+    struct Binding
+    {
+        std::function<bool()> alive;
+        ListenerToken token;
+    };
+
+    /// Frees the retired arrays if no dispatch is in flight (mutex must be held)
+    void reclaim() const;
+
+    /// Ends a dispatch: the last one to finish reclaims the retired arrays
+    void endDispatch() const;
+
+    std::atomic<Entries const*> entries = nullptr;
+
+    /// Size of the current array, so that empty() never reads an array which add() may retire and free
+    std::atomic<std::size_t> count = 0;
+
+    mutable std::atomic<std::uint32_t> dispatching = 0;
+    mutable std::atomic<bool> hasRetired = false;
+
+    // only accessed with mutex held
+    mutable std::mutex mutex;
+    mutable std::vector<std::unique_ptr<Entries const>> retired;
+    std::vector<Binding> bindings;
+};
+} // namespace detail
+
+/**
+ * @brief RAII scope selecting the memory resource for Array and Map storage
+ *
+ * Array<T> and Map<T> allocate their element storage from the memory resource
+ * which is active on the current thread when they are constructed. Containers
+ * also activate their own resource while constructing elements, so the resource
+ * propagates down a tree of nested containers. Record<T>'s constructors taking a
+ * std::pmr::memory_resource* open such a scope for the whole record.
+ *
+ * @code
+ * std::pmr::monotonic_buffer_resource arena;
+ * Record<State> state(&arena);     // all nested Array/Map storage comes from arena
+ * @endcode
+ *
+ * @note The resource must outlive every container allocated from it. Leaf values
+ *       (e.g. std::string) and listener storage still use the global heap.
+ */
+class MemoryResourceScope
+{
+public:
+    /// Makes resource the active memory resource of this thread until destruction
+    explicit MemoryResourceScope(std::pmr::memory_resource* resource);
+
+    /// Restores the previously active memory resource
+    ~MemoryResourceScope();
+
+    MemoryResourceScope(MemoryResourceScope const&) = delete;
+    MemoryResourceScope& operator=(MemoryResourceScope const&) = delete;
+
+    /// Returns the active memory resource of this thread (std::pmr::get_default_resource() if none)
+    static std::pmr::memory_resource* current();
+
+private:
+    std::pmr::memory_resource* previous;
+
+    static thread_local std::pmr::memory_resource* active;
+};
+
 //=============================================================================
 // Public API classes
 //=============================================================================
@@ -213,14 +510,19 @@ private:
 class Value
 {
 private:
-    /// Tuple of all primitive types supported by the visitor pattern
-    using SupportedFundamentalTypes = std::tuple<
+    /// Tuple of all primitive types supported by the visitor pattern out of the box
+    using BuiltinFundamentalTypes = std::tuple<
         int8_t, int16_t, int32_t, int64_t,
-        float, double,
+        uint8_t, uint16_t, uint32_t, uint64_t,
+        float, double, long double,
         bool,
         std::string, ID
     >;
 
+    /// Built-in types followed by the types registered via ExtraFundamentalTypes
+    using SupportedFundamentalTypes = decltype(std::tuple_cat(std::declval<BuiltinFundamentalTypes>(),
+                                                              std::declval<ExtraFundamentalTypes<>::Types>()));
+
 public:
     /// Global singleton representing an invalid/missing value
     static Invalid& kInvalid;
@@ -277,6 +579,27 @@ public:
      */
     virtual bool assign(Value const& other) = 0;
 
+    /**
+     * @brief Returns a hash of the content of this value
+     *
+     * Values with different hashes are never equal. Records, Arrays and Maps
+     * compute their hash on first call and cache it; a change invalidates only
+     * the cached hashes of the changed value's ancestors, so unchanged subtrees
+     * are not rehashed. Leaf types which are neither arithmetic, std::string, ID,
+     * std::hash-able nor free of padding bits do not contribute their value.
+     */
+    virtual std::uint64_t contentHash() const = 0;
+
+    /**
+     * @brief Returns the version of the last change of this value (0 if it never changed)
+     *
+     * Every change in a tree increments the version counter of the tree's root and
+     * stamps the changed value with the new version: the changed leaf, a Record set
+     * as a whole, or an Array/Map which gained or lost an element (an added element
+     * is stamped as well). See Object::changedSince().
+     */
+    std::uint64_t version() const { return lastChangedVersion; }
+
     /** Assignment operator - uses above assign method */
     Value& operator=(Value const&);
 
@@ -285,34 +608,65 @@ protected:
     friend class Object;
     template <typename T> friend class Fundamental;
     template <typename T> friend class Record;
+    template <typename T> friend class Array;
+    template <typename T> friend class Map;
+    template <typename T, std::size_t NumShards> friend class ConcurrentMap;
+    friend class LeafPath;
 
-    using TypesVariant = detail::apply_tuple<std::variant, detail::transform_tuple<SupportedFundamentalTypes, detail::add_reference_wrapper>::type>::type;
-    using ConstTypesVariant = detail::apply_tuple<std::variant, detail::transform_tuple<SupportedFundamentalTypes, detail::add_const_reference_wrapper>::type>::type;
+    /// Type tags stored in typeIndex. Fundamental types are tagged with
+    /// kFirstFundamentalTypeIndex + their position in SupportedFundamentalTypes.
+    static constexpr std::uint8_t kInvalidTypeIndex = 0;
+    static constexpr std::uint8_t kObjectTypeIndex = 1;
+    static constexpr std::uint8_t kFirstFundamentalTypeIndex = 2;
 
-    virtual TypesVariant visit_helper();
-    virtual ConstTypesVariant visit_helper() const;
+    static_assert(kFirstFundamentalTypeIndex + std::tuple_size_v<SupportedFundamentalTypes> <= 0xff, "Too many fundamental types registered");
 
-    
     constexpr Value() = default;
+    constexpr explicit Value(std::uint8_t typeIndex_) : typeIndex(typeIndex_) {}
     // don't copy parent
     Value(Value const&);
     Value(Value&& o);
 
+    /// Jump table entry of visit(): invokes the lambda with self cast to Arg
+    template <typename Arg, typename ReturnType, typename ValueRef, typename Lambda>
+    static ReturnType visitAs(ValueRef self, Lambda& lambda);
+
     /**
-     * @brief Binds a listener token to a context for automatic cleanup
+     * @brief Records a change of this value
+     *
+     * Stamps this value with the next version of its tree, raises the subtree
+     * version of all its ancestors to it and drops their cached content hashes.
      *
-     * Associates a ListenerToken with a weak_ptr to a context. When the
-     * context expires, the binding can be detected and removed, which
-     * destroys the token and removes the listener.
+     * @return True if a record above this value has field hooks (see runFieldHooks())
      */
-    struct ListenerBinding
-    {
-        std::weak_ptr<void> context;
-        ListenerToken token;
-    };
+    bool markChanged() const;
+
+    /// True if this thread assigns a record above this value as a whole, which runs the hooks of its fields and notifies once it is stored
+    bool isInAssignedRecord() const;
+
+    /**
+     * @brief Runs the field hooks of the records above this value after it changed (see NoFieldHooks)
+     *
+     * @param hooked The result of markChanged(): nothing is walked if no record above this value has hooks
+     * @param ownHooksRan True if the hooks of this field already ran (see Field), so that its record
+     *                    only reacts to the change with the fields computed from it
+     */
+    void runFieldHooks(bool hooked, bool ownHooksRan = false);
+
+    /// Takes over the version stamps of o and its descendants. Used when a value is relocated within its tree.
+    virtual void copyVersionsFrom(Value const& o) { lastChangedVersion = o.lastChangedVersion; }
 
     Object* parent = nullptr;
-    static thread_local std::size_t recursiveListenerDisabler;
+
+    /// Compact tag identifying the dynamic type of this value (see kInvalidTypeIndex et al.)
+    std::uint8_t typeIndex = kInvalidTypeIndex;
+
+    // not copied: versions are only comparable within one tree
+    mutable std::uint64_t lastChangedVersion = 0;
+
+    // The record this thread assigns as a whole, or the map relocating its elements, if any (see
+    // Fundamental::store()): the notifications of its descendants are suppressed. An assignment never suspends, so the state can be per thread.
+    static thread_local Value const* assignedRecord;
 };
 
 /**
@@ -342,13 +696,14 @@ public:
     bool isValid() const override { return false; }
     constexpr operator bool() const { return false; }
     bool assign(Value const&) override { return false; }
+    std::uint64_t contentHash() const override { return 0; }
 };
 
 /**
  * @brief Abstract base class for struct types containing Field<> members
  *
  * Object extends Value to add struct-specific functionality:
- *   - Field iteration via typeErasedFields()
+ *   - Field iteration via fieldRange() and typeErasedFields()
  *   - Runtime field access by name via operator()(string_view)
  *   - Hierarchical path-based field access via getchild()
  *   - Recursive child change listeners via addChildListener()
@@ -378,6 +733,8 @@ public:
     /// Move constructor
     Object(Object&& o);
 
+    ~Object() override;
+
     bool isStruct() const override { return true; }
     virtual bool isMapOrArray() const { return false; }
 
@@ -444,12 +801,86 @@ public:
     void addChildListener(ComponentType* context, Lambda && lambda) requires std::is_base_of_v<juce::Component, ComponentType>;
    #endif
 
+    /**
+     * @brief Register a listener for changes to any child field which does not need the path
+     *
+     * Called for the same changes as the listeners of addChildListener(), but a
+     * change is described by the object holding the changed value and the name
+     * of the value in it instead of by its path, so that notifying allocates no
+     * ID. pathTo() builds the path on demand, isPathTo() compares a known path
+     * without building it. The elements of a ConcurrentMap are reported as
+     * children of the map, like in paths.
+     *
+     * @param lambda Callback: (Object const& parentOfChangedValue, std::string_view name, Operation operation, Value const& newValue)
+     * @return ListenerToken that removes the listener when destroyed
+     */
+    template <std::invocable<Object const&, std::string_view, Operation, Value const&> Lambda>
+    ListenerToken addPathFreeChildListener(Lambda && lambda);
+
+    /// Returns the path of the value called name in descendant (an Object below or equal to this one), relative to this object
+    ID pathTo(Object const& descendant, std::string_view name) const;
+
+    /// True if path equals pathTo(descendant, name). Does not build the path.
+    bool isPathTo(ID const& path, Object const& descendant, std::string_view name) const;
+
+    /**
+     * @brief Register a listener which receives changes below this object at most once per interval
+     *
+     * Instead of every change, the listener receives the latest value of every
+     * path which changed since its last delivery (see changedSince(); removed
+     * elements are reported as a change of their container). A change is
+     * delivered right away if the previous delivery is at least interval ago.
+     * Changes arriving within the interval are delivered by a later change or by
+     * flushCoalescedChildListeners(), which should be called periodically, e.g.
+     * on every frame. Pass std::chrono::nanoseconds::max() to deliver only on
+     * flushes.
+     *
+     * Changes which are not delivered cost neither path allocations nor calls of
+     * the listener.
+     *
+     * @param lambda Callback: (ID const& idToChangedValue, Value const& latestValue)
+     * @return ListenerToken that removes the listener when destroyed
+     */
+    template <std::invocable<ID const&, Value const&> Lambda>
+    ListenerToken addCoalescedChildListener(std::chrono::nanoseconds interval, Lambda && lambda);
+
+    /// Delivers the pending changes of all coalesced child listeners of this object (on the thread which changes the tree)
+    void flushCoalescedChildListeners() const;
+
     /// Returns a vector of references to all fields (const version)
     virtual std::vector<std::reference_wrapper<Value const>> typeErasedFields() const { assert(false); return {}; }
 
     /// Returns a vector of references to all fields (mutable version)
     virtual std::vector<std::reference_wrapper<Value>> typeErasedFields() { assert(false); return {}; }
 
+    /// Returns the number of fields, i.e. typeErasedFields().size() without building the vector
+    virtual std::size_t fieldCount() const { assert(false); return 0; }
+
+    /// Returns the field at position idx of typeErasedFields() without building the vector, or kInvalid if idx is out of range
+    virtual Value const& fieldAt(std::size_t /*idx*/) const { assert(false); return kInvalid; }
+
+    /// Returns the field at position idx of typeErasedFields() without building the vector, or kInvalid if idx is out of range
+    virtual Value& fieldAt(std::size_t /*idx*/) { assert(false); return kInvalid; }
+
+    /**
+     * @brief Returns a range over all fields which does not allocate
+     *
+     * Visits the same fields in the same order as typeErasedFields(), but
+     * through fieldCount() and fieldAt() instead of building a vector:
+     *
+     * @code
+     * for (auto& fld : object.fieldRange())
+     *     std::cout << fld.fieldname() << std::endl;
+     * @endcode
+     *
+     * The range is invalidated when fields are added or removed.
+     */
+    auto fieldRange(this auto& self)
+    {
+        using ObjectType = std::conditional_t<std::is_const_v<std::remove_reference_t<decltype(self)>>, Object const, Object>;
+        return FieldRange<ObjectType>(static_cast<ObjectType&>(self));
+    }
+
     /**
      * @brief Access a field by name at runtime
      *
@@ -472,6 +903,38 @@ public:
      */
     auto getchild(this auto& self, ID subid) -> std::conditional_t<std::is_const_v<std::remove_reference_t<decltype(self)>>, Value const&, Value&>;
 
+    /**
+     * @brief Releases the elements of lazily loaded containers in this subtree
+     *
+     * Every Array and Map which was loaded from a LazyElementSource and has not been
+     * modified since goes back to its compact form; its elements are loaded from the
+     * source again on next access. Call this under memory pressure. References to
+     * and listeners of released elements become invalid.
+     *
+     * @return The number of containers released
+     */
+    virtual std::size_t compact();
+
+    /// Returns the highest version() within this subtree. For the root of a tree this is the tree's current version.
+    std::uint64_t subtreeVersion() const { return lastSubtreeVersion.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the values below this Object which changed after version
+     *
+     * Only subtrees which changed are visited, so publishing the changes since the
+     * last publish costs time proportional to the changes rather than to the tree:
+     *
+     * @code
+     * for (auto const& [path, value] : state.changedSince(lastPublished))
+     *     publish(path, value);
+     *
+     * lastPublished = state.subtreeVersion();
+     * @endcode
+     *
+     * Removed elements are not visited: their container is visited instead, as it changed.
+     */
+    ChangedValueRange changedSince(std::uint64_t version) const;
+
     // Copy assignment operator (does not copy listeners)
     Object& operator=(Object const&);
 
@@ -484,9 +947,53 @@ public:
     MetaType const& metaType() const override;
     bool isValid() const override { assert(false); return false; }
     bool assign(Value const&) override { assert(false); return false; }
+    std::uint64_t contentHash() const override { assert(false); return 0; }
 
 protected:
-    Object() = default;
+    Object() : Value(kObjectTypeIndex) {}
+
+    /// Statically dispatched reactions of a record to changes of its fields (see NoFieldHooks)
+    struct FieldHooks
+    {
+        /// Called after field, a field of record or one of its descendants, changed (ownHooksRan: see Value::runFieldHooks())
+        void (*changed)(Object& record, Value& field, bool ownHooksRan);
+
+        /// Called after record was assigned as a whole
+        void (*assigned)(Object& record);
+
+        /// Called before a field of record is read: computes the computed fields which are out of date (see Computed)
+        void (*refresh)(Object const& record);
+    };
+
+    // only set by records which have fields with hooks
+    FieldHooks const* fieldHooks = nullptr;
+
+    /// Called whenever this object or one of its descendants changed, before child listeners are notified
+    virtual void childChanged() const {}
+
+    /// True if the children of this object are not constructed yet (see LazyElementSource)
+    virtual bool hasUnloadedChildren() const { return false; }
+
+    void copyVersionsFrom(Value const& o) override;
+
+    /// Returns the cached content hash, recomputing it with compute() if this subtree changed since
+    template <typename Compute>
+    std::uint64_t cachedContentHash(Compute && compute) const
+    {
+        if (! contentHashValid.load(std::memory_order_relaxed))
+        {
+            contentHashCache = compute();
+            contentHashValid.store(true, std::memory_order_relaxed);
+        }
+
+        return contentHashCache;
+    }
+
+    /// Returns the cached content hash if it is up to date
+    std::optional<std::uint64_t> cachedContentHash() const
+    {
+        return contentHashValid.load(std::memory_order_relaxed) ? std::optional<std::uint64_t>(contentHashCache) : std::nullopt;
+    }
 
 private:
     template <typename T>
@@ -498,12 +1005,199 @@ private:
     template <typename T>
     friend class Map;
 
+    template <typename T, std::size_t NumShards>
+    friend class ConcurrentMap;
+
+    template <typename T, fixstr::fixed_string Name, typename Function, fixstr::fixed_string... Dependencies>
+    friend class Computed;
+
+    /// The kinds of child listeners which a change below an object reaches (see propagateChildChange())
+    struct ChildListenerKinds
+    {
+        bool withPath = false;
+        bool pathFree = false;
+
+        explicit operator bool() const { return withPath || pathFree; }
+    };
+
+    /**
+     * Tells this object and its ancestors that a descendant changed: calls childChanged() and
+     * delivers coalesced child listeners which are due. Returns which kinds of child listeners
+     * they have, so that the caller can skip building the change's path.
+     */
+    ChildListenerKinds propagateChildChange() const;
+
+    /// Calls the child listeners of this object and its ancestors for a change of its child called name (call propagateChildChange() first)
+    void notifyChildChange(ChildListenerKinds kinds, std::string const& name, Operation op, Value const& newValue) const;
+
+    /// Calls the child listeners of this object and its ancestors (call propagateChildChange() first)
     void callChildListeners(ID const& id, Operation op, Object const& parentOfChangedValue, Value const& newValue) const;
 
+    /// Calls the path-free child listeners of this object and its ancestors (call propagateChildChange() first)
+    void callPathFreeChildListeners(std::string_view name, Operation op, Object const& parentOfChangedValue, Value const& newValue) const;
+
     using ChildListenerFunction = std::function<void(ID const&, Operation, Object const&, Value const&)>;
+    using PathFreeChildListenerFunction = std::function<void(Object const&, std::string_view, Operation, Value const&)>;
+
+    mutable detail::ListenerList<ChildListenerFunction> childListeners;
+    mutable detail::ListenerList<PathFreeChildListenerFunction> pathFreeChildListeners;
+
+    using Clock = std::chrono::steady_clock;
+
+    /// Delivers the changes since its last delivery if due (or if flush is true) and returns the time of its next delivery
+    using CoalescedListenerFunction = std::function<Clock::time_point(Object const&, Clock::time_point now, bool flush)>;
+
+    struct CoalescedChildListeners
+    {
+        detail::ListenerList<CoalescedListenerFunction> listeners;
+
+        // earliest next delivery of the listeners, in ticks of Clock
+        std::atomic<Clock::rep> nextDelivery = std::numeric_limits<Clock::rep>::max();
+    };
+
+    CoalescedChildListeners& coalescedChildListeners() const;
+    void deliverCoalescedChildListeners(Clock::time_point now, bool flush) const;
+
+    // allocated on first use: most objects have no coalesced listeners
+    mutable std::atomic<CoalescedChildListeners*> coalesced = nullptr;
+
+    /**
+     * Stamps this object and its ancestors with the next version of their tree in a single walk and
+     * returns it. shared is true above a shard: the version is handed out and raised atomically there.
+     * Sets hooked if a record above this object has field hooks.
+     */
+    std::uint64_t stampSubtree(bool shared, bool& hooked) const;
+
+    /// Runs the field hooks of the ancestors of changed (see Value::runFieldHooks())
+    static void runFieldHooksAbove(Value& changed, bool ownHooksRan);
+
+    friend class Value;
+    friend class LeafPath;
+
+    // Only set on the shards of a ConcurrentMap: the ancestors of a shard are shared by the writers of all
+    // shards. They are stamped lock-free, and this mutex serializes running their hooks and listeners,
+    // which is only locked if one of them has any. Shards are not part of paths.
+    std::mutex* sharedAncestorsMutex = nullptr;
+
+    // not copied: a copy computes its own hash on first use
+    mutable std::uint64_t contentHashCache = 0;
+    mutable std::atomic<bool> contentHashValid = false;
+    mutable std::atomic<std::uint64_t> lastSubtreeVersion = 0;
+};
+
+/**
+ * @brief Range over the fields of an Object, see Object::fieldRange()
+ *
+ * @tparam ObjectType Object or Object const
+ */
+template <typename ObjectType>
+class FieldRange
+{
+public:
+    using ValueType = std::conditional_t<std::is_const_v<ObjectType>, Value const, Value>;
+
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Value;
+        using difference_type = std::ptrdiff_t;
+        using pointer = ValueType*;
+        using reference = ValueType&;
+
+        iterator() = default;
+
+        ValueType& operator*() const { return object->fieldAt(idx); }
+        ValueType* operator->() const { return &object->fieldAt(idx); }
+
+        iterator& operator++() { ++idx; return *this; }
+        iterator operator++(int) { auto copy = *this; ++idx; return copy; }
 
-    mutable std::map<std::weak_ptr<ListenerToken::Impl>, ChildListenerFunction, std::owner_less<std::weak_ptr<ListenerToken::Impl>>> childListeners;
-    mutable std::vector<Value::ListenerBinding> managedChildListeners;
+        bool operator==(iterator const& o) const { return object == o.object && idx == o.idx; }
+
+    private:
+        friend class FieldRange;
+        iterator(ObjectType* object_, std::size_t idx_) : object(object_), idx(idx_) {}
+
+        ObjectType* object = nullptr;
+        std::size_t idx = 0;
+    };
+
+    iterator begin() const { return iterator(&object, 0); }
+    iterator end() const { return iterator(&object, count); }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    ValueType& operator[](std::size_t idx) const { return object.fieldAt(idx); }
+
+private:
+    friend class Object;
+    explicit FieldRange(ObjectType& object_) : object(object_), count(object_.fieldCount()) {}
+
+    ObjectType& object;
+    std::size_t count;
+};
+
+/**
+ * @brief Range over the values of a subtree which changed after a given version
+ *
+ * Returned by Object::changedSince(). Subtrees whose Object::subtreeVersion()
+ * is not newer are skipped without being visited. Values are visited in
+ * depth-first order, parents before their children. The range is invalidated
+ * by any change to the tree.
+ */
+class ChangedValueRange
+{
+public:
+    struct Entry
+    {
+        ID const& path;      ///< Path of the value, relative to the Object changedSince() was called on
+        Value const& value;
+    };
+
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+
+        Entry operator*() const { return { path, *current }; }
+
+        iterator& operator++() { advance(); return *this; }
+        void operator++(int) { advance(); }
+
+        bool operator==(std::default_sentinel_t) const { return current == nullptr; }
+
+    private:
+        friend class ChangedValueRange;
+
+        struct Frame
+        {
+            Object const* object;
+            std::size_t count;
+            std::size_t next = 0;
+        };
+
+        iterator(Object const& root, std::uint64_t since_);
+        void advance();
+
+        std::uint64_t since;
+        std::vector<Frame> stack;
+        ID path;
+        Value const* current = nullptr;
+    };
+
+    iterator begin() const { return iterator(root, since); }
+    std::default_sentinel_t end() const { return {}; }
+
+private:
+    friend class Object;
+    ChangedValueRange(Object const& root_, std::uint64_t since_) : root(root_), since(since_) {}
+
+    Object const& root;
+    std::uint64_t since;
 };
 
 /**
@@ -530,15 +1224,11 @@ public:
     static constexpr auto kIsOpaque = Value::isOpaque<T>();
 
     // T must either be a struct with Fields (see Field class below) or it must be one of SupportedFundamentalTypes
+    // (register additional types by specializing ExtraFundamentalTypes)
     static_assert(
         (! kIsOpaque) ||
-        (std::invoke(
-            [] <typename... Type> (std::type_identity<std::tuple<Type...>>)
-            {
-                return (std::is_same_v<T, Type> || ...);
-            },
-            std::type_identity<Value::SupportedFundamentalTypes>()
-        ))
+        (detail::tuple_index<T, Value::SupportedFundamentalTypes>::value < std::tuple_size_v<Value::SupportedFundamentalTypes>),
+        "Unsupported fundamental type: register it by specializing dynamic::ExtraFundamentalTypes"
     );
 
     using Base = std::conditional_t<kIsOpaque, Value, Object>;
@@ -546,6 +1236,15 @@ public:
     /// Compile-time constant indicating this is always a valid value
     static constexpr auto kIsValid = true;
 
+    /// Type tag stored in Value::typeIndex for instances of this class
+    static constexpr std::uint8_t kTypeIndex = std::invoke([]
+    {
+        if constexpr (kIsOpaque)
+            return static_cast<std::uint8_t>(Value::kFirstFundamentalTypeIndex + detail::tuple_index<T, Value::SupportedFundamentalTypes>::value);
+        else
+            return Value::kObjectTypeIndex;
+    });
+
     /// Default constructor - creates a Fundamental with default-initialized value
     Fundamental();
 
@@ -585,9 +1284,24 @@ public:
     /// Move assignment operator with listener notification
     Fundamental& operator=(Fundamental && newValue);
 
+    /// True if load() may be called concurrently with a writer, see ConcurrentReads
+    static constexpr auto kConcurrentReads = kIsOpaque && ConcurrentReads<T>::value;
+
+    static_assert((! kConcurrentReads) || std::is_trivially_copyable_v<T>,
+                  "ConcurrentReads requires a trivially copyable type");
+
     /// Returns the underlying value (read-only access)
     T const& operator()() const { return underlying; }
 
+    /**
+     * @brief Returns a copy of the value, safe to call while another thread writes it
+     *
+     * Lock-free and tear-free. Only one thread may change the value at a time;
+     * all other accessors (operator(), visit(), ...) must only be used on that
+     * thread.
+     */
+    T load() const requires kConcurrentReads;
+
     /// Mutable member access for struct types — allows chaining through Field members
     /// while preserving listener safety (mutations go through Field::operator= or set())
     T*       operator->()       requires (!kIsOpaque) { return &underlying; }
@@ -651,22 +1365,65 @@ public:
 
     // overridden base methods
     bool assign(Value const&) override;
+    std::uint64_t contentHash() const override;
 
    #if JUCE_SUPPORT
     juce::Value getUnderlyingValue() requires kIsOpaque;
    #endif
 
 protected:
+    friend class Value;
+    template <typename> friend struct detail::ParallelCopy;
+
     using ValueListenerFunction = std::function<void(Fundamental<T> const&)>;
 
     void callListeners();
 
-    typename Value::TypesVariant visit_helper() override;
-    typename Value::ConstTypesVariant visit_helper() const override;
+    /// Returns true if a and b are considered equal (floating point values are compared with epsilon)
+    static bool isEqual(T const& a, T const& b);
 
-    T underlying;
-    mutable std::map<std::weak_ptr<ListenerToken::Impl>, ValueListenerFunction, std::owner_less<std::weak_ptr<ListenerToken::Impl>>> valueListeners = {};
-    mutable std::vector<Value::ListenerBinding> managedValueListeners = {};
+    /// Runs a mutable visitor directly on the underlying value and notifies listeners once if it changed
+    template <typename Lambda>
+    decltype(auto) visitInPlace(Lambda& lambda);
+
+    /**
+     * Records a change of the value and notifies listeners, unless an ancestor is being assigned as a whole.
+     * FieldType is the Field whose typed write path made the change (see Field): its hooks are called
+     * directly instead of through the table of its record.
+     */
+    template <typename FieldType = void>
+    void notifyChanged();
+
+    /// set() for the typed write paths of FieldType (see notifyChanged())
+    template <typename FieldType, typename U>
+    void setField(U && newValue);
+
+    /// Writes the underlying value, atomically with respect to load() if kConcurrentReads
+    template <typename U>
+    void store(U&& newValue);
+
+    static constexpr auto kUsesSequenceLock = std::invoke([]
+    {
+        if constexpr (kConcurrentReads)
+            return ! std::atomic_ref<T>::is_always_lock_free;
+        else
+            return false;
+    });
+
+    static constexpr std::size_t kUnderlyingAlignment = std::invoke([]
+    {
+        if constexpr (kConcurrentReads && ! kUsesSequenceLock)
+            return alignof(T) > std::atomic_ref<T>::required_alignment ? alignof(T) : std::atomic_ref<T>::required_alignment;
+        else
+            return alignof(T);
+    });
+
+    alignas(kUnderlyingAlignment) T underlying;
+
+    // odd while a store is in progress (empty member unless kUsesSequenceLock)
+    [[no_unique_address]] std::conditional_t<kUsesSequenceLock, std::atomic<std::uint32_t>, std::type_identity<void>> sequence = {};
+
+    mutable detail::ListenerList<ValueListenerFunction> valueListeners;
 private:
    #if JUCE_SUPPORT
     struct DynamicValueSource : juce::Value::ValueSource
@@ -739,6 +1496,10 @@ class Record : public Fundamental<T>
 private:
     static auto fields_with(T& u);
     static auto fields_with(T const& u);
+
+    /// Delegation targets of the memory resource constructors: scope is active during construction
+    Record(MemoryResourceScope const& scope);
+    Record(T const& underlying_, MemoryResourceScope const& scope);
 public:
     /// Default constructor - creates a Record with default-initialized underlying value
     Record();
@@ -746,6 +1507,12 @@ public:
     /// Construct from underlying struct value
     Record(T const& underlying_);
 
+    /// Default construct, allocating all nested Array/Map storage from resource
+    explicit Record(std::pmr::memory_resource* resource);
+
+    /// Construct from underlying struct value, allocating all nested Array/Map storage from resource
+    Record(T const& underlying_, std::pmr::memory_resource* resource);
+
     /// Copy constructor
     Record(Record const& o);
 
@@ -776,17 +1543,21 @@ public:
     static constexpr std::array<std::string_view const, std::tuple_size_v<FieldsAsTuple>> kFieldNames =
         std::invoke([] <typename... Types> (std::type_identity<std::tuple<Types...>>)
         {
-            std::array<std::string_view const, std::tuple_size_v<FieldsAsTuple>> returnValue = {{
-                std::invoke([] <typename U, fixstr::fixed_string Name> (std::type_identity<Field<U, Name>>)
-                    -> std::string_view
-                {
-                    return Name;
-                }, std::type_identity<Types>())...
-            }};
+            std::array<std::string_view const, std::tuple_size_v<FieldsAsTuple>> returnValue = {{ Types::kFieldName... }};
 
             return returnValue;
         }, std::type_identity<FieldsAsTuple>());
 
+    /**
+     * @brief Structural fingerprint of T, equal to meta().schemaHash()
+     *
+     * Covers field names, field order and (recursively) field types, so it can be
+     * compared in a static_assert or sent in a message header:
+     * @code
+     * static_assert(Record<Point>::kSchemaHash == Record<RemotePoint>::kSchemaHash);
+     * @endcode
+     */
+    static constexpr std::uint64_t kSchemaHash = detail::SchemaHash<T>::value;
 
     /**
      * @brief Access a field by compile-time name using "_fld" literal
@@ -801,7 +1572,8 @@ public:
      * @brief Returns a tuple of references to all typed fields
      *
      * Unlike typeErasedFields(), this returns a tuple with the actual Field<> types,
-     * allowing compile-time access to field types and names.
+     * allowing compile-time access to field types and names. Computed fields
+     * which are out of date are computed first (see Computed).
      *
      * @return Tuple of references to Field<> members
      */
@@ -813,6 +1585,10 @@ public:
     /// Returns type-erased references to all fields (mutable version)
     std::vector<std::reference_wrapper<Value>> typeErasedFields() override;
 
+    std::size_t fieldCount() const override { return kFieldNames.size(); }
+    Value const& fieldAt(std::size_t idx) const override;
+    Value& fieldAt(std::size_t idx) override;
+
     /**
      * @brief Visit all fields with a lambda
      *
@@ -844,9 +1620,57 @@ private:
     auto typeErasedFields_internal(this auto& self);
 
     void init();
+
+    /// True if a field of T has hooks (see NoFieldHooks) or is computed (see Computed)
+    static constexpr bool kHasFieldHooks = std::invoke([] <typename... Types> (std::type_identity<std::tuple<Types...>>)
+    {
+        return ((Types::kHasHooks || Types::kIsComputed) || ...);
+    }, std::type_identity<FieldsAsTuple>());
+
+    /// True if T has computed fields (see Computed)
+    static constexpr bool kHasComputedFields = std::invoke([] <typename... Types> (std::type_identity<std::tuple<Types...>>)
+    {
+        return (Types::kIsComputed || ...);
+    }, std::type_identity<FieldsAsTuple>());
+
+    /// Marks the fields computed from the field which is or contains field as out of date, then runs its hooks (unless ownHooksRan)
+    static void fieldChanged(Object& record, Value& field, bool ownHooksRan);
+
+    /// Marks all computed fields as out of date, then runs the hooks of all fields
+    static void recordAssigned(Object& record);
+
+    /// Computes the computed fields of record which are out of date
+    static void refresh(Object const& record);
+
+    /// Marks the fields computed from changed, and the fields computed from those, as out of date
+    static void invalidate(Record& self, Value const& changed);
+
+    /// Runs the hooks of field, a field of record
+    template <typename FieldType>
+    static void runHooks(FieldType& field, Object& record);
+
+    /// Indices of the fields ComputedType is computed from
+    template <typename ComputedType>
+    static constexpr auto dependencyIndices()
+    {
+        std::array<std::size_t, ComputedType::kDependencies.size()> indices = {};
+
+        for (std::size_t dep = 0; dep < indices.size(); ++dep)
+            indices[dep] = static_cast<std::size_t>(std::ranges::find(kFieldNames, ComputedType::kDependencies[dep]) - kFieldNames.begin());
+
+        return indices;
+    }
+
+    /// Computes the value of the computed field of type ComputedType from its dependencies
+    template <typename ComputedType>
+    auto computeValue();
+
+    static constexpr Object::FieldHooks kFieldHooks = { &fieldChanged, &recordAssigned, &refresh };
 };
 
 
+/// Two records are equal if all their fields are equal
+template <typename T> bool operator==(Record<T> const&, Record<T> const&);
 template <typename T> bool operator==(Array<T> const&, Array<T> const&);
 template <typename T> bool operator==(Map<T>   const&, Map<T>   const&);
 
@@ -854,6 +1678,39 @@ template <typename T> bool operator==(Map<T>   const&, Map<T>   const&);
 
 namespace dynamic
 {
+/**
+ * @brief Backing store of a lazily loaded Array<T> or Map<T>
+ *
+ * A lazy container answers size() (and, for maps, contains()) from its source
+ * and only constructs its elements on first element access: operator[], find(),
+ * iteration, getchild() or any modification. See Array::setLazySource.
+ */
+template <typename T>
+class LazyElementSource
+{
+public:
+    virtual ~LazyElementSource() = default;
+
+    /// Returns the number of elements
+    virtual std::size_t size() const = 0;
+
+    /// Returns the value of the idx-th element
+    virtual T element(std::size_t idx) const = 0;
+
+    /// Returns the key of the idx-th element (only used by Map)
+    virtual std::string_view key(std::size_t /*idx*/) const { return {}; }
+
+    /// Returns the index of the element with the given key (only used by Map). Searches linearly by default.
+    virtual std::optional<std::size_t> find(std::string_view key_) const
+    {
+        for (std::size_t idx = 0, n = size(); idx < n; ++idx)
+            if (key(idx) == key_)
+                return idx;
+
+        return std::nullopt;
+    }
+};
+
 /**
  * @brief Dynamic array container with reflection and change notification support
  *
@@ -885,8 +1742,30 @@ public:
     using Object::operator();
 
     Array() = default;
+
+    /// Copy constructor - allocates from MemoryResourceScope::current(), not from o's resource
     Array(Array const& o);
 
+    /// Move constructor - takes over the elements, memory resource and listeners of o
+    Array(Array&& o);
+
+    /**
+     * @brief Replaces the contents of this array with the elements of source, loaded on first access
+     *
+     * Intended for loading state: listeners are notified of the removal of the
+     * current elements, but not of the elements of source. Copies of a lazy
+     * array which was not modified share the source.
+     */
+    void setLazySource(std::shared_ptr<LazyElementSource<T> const> source);
+
+    /// Returns false if this is a lazy array whose elements were not constructed yet
+    bool isLoaded() const { return ! lazyPending; }
+
+    std::size_t compact() override;
+
+    /// Returns the memory resource used for the element storage
+    std::pmr::memory_resource* resource() const { return elements.get_allocator().resource(); }
+
     /// Returns the type_info for Array<T>
     std::type_info const& type() const override { return typeid(Array<T>); }
 
@@ -911,8 +1790,13 @@ public:
     /// Returns a vector of type-erased references to all elements (mutable version)
     std::vector<std::reference_wrapper<Value>> typeErasedFields() override;
 
+    /// Returns the number of elements. Unlike size(), this constructs the elements of a lazy array.
+    std::size_t fieldCount() const override { return loadedElements().size(); }
+    Value const& fieldAt(std::size_t idx) const override;
+    Value& fieldAt(std::size_t idx) override;
+
     /// Returns the number of elements in the array
-    std::size_t size() const { return elements.size(); }
+    std::size_t size() const { return lazyPending ? lazySource->size() : elements.size(); }
 
     /**
      * @brief Add an element to the end of the array
@@ -976,6 +1860,7 @@ public:
 
     // overridden base methods
     bool assign(Value const&) override;
+    std::uint64_t contentHash() const override;
     bool assignChild(std::string const&, Value const&) override;
     bool removeChild(std::string const&) override;
 
@@ -988,6 +1873,7 @@ public:
     }
 
     friend bool operator==<>(Array<T> const&, Array<T> const&);
+    template <typename, typename> friend struct detail::ParallelContainerCopy;
 private:
     auto typeErasedFields_internal(this auto && self);
 
@@ -1037,11 +1923,22 @@ private:
 
     using ArrayListenerFunction = std::function<void(Operation, Array<T> const&, T const&, std::size_t)>;
 
-    void callListeners(Operation op, T const& newValue, std::size_t idx) const;
+    void callListeners(Operation op, T const& newValue, std::size_t idx);
+
+    using ElementVector = std::pmr::vector<Element>;
+
+    /// Constructs the elements of a lazy array if they were not constructed yet
+    void load() const;
+    ElementVector& loadedElements() const { load(); return elements; }
 
-    std::vector<Element> elements;
-    mutable std::map<std::weak_ptr<ListenerToken::Impl>, ArrayListenerFunction, std::owner_less<std::weak_ptr<ListenerToken::Impl>>> arrayListeners;
-    mutable std::vector<Value::ListenerBinding> managedArrayListeners;
+    void childChanged() const override { std::atomic_ref(lazyModified).store(true, std::memory_order_relaxed); }
+    bool hasUnloadedChildren() const override { return lazyPending; }
+
+    // mutable: elements of lazy arrays are constructed on first (possibly const) access
+    mutable ElementVector elements { MemoryResourceScope::current() };
+    std::shared_ptr<LazyElementSource<T> const> lazySource;
+    mutable bool lazyPending = false, lazyModified = false;
+    mutable detail::ListenerList<ArrayListenerFunction> arrayListeners;
 
 public:
     /// The typed element type (Fundamental<T> for primitive T, Record<T> for struct T)
@@ -1050,19 +1947,19 @@ public:
     /// Typed element access by index
     ElementType& operator[](std::size_t idx)
     {
-        assert(idx < elements.size());
-        return elements[idx];
+        assert(idx < size());
+        return loadedElements()[idx];
     }
 
     /// Typed element access by index (const)
     ElementType const& operator[](std::size_t idx) const
     {
-        assert(idx < elements.size());
-        return elements[idx];
+        assert(idx < size());
+        return loadedElements()[idx];
     }
 
     /// Returns true if the array has no elements
-    bool empty() const { return elements.empty(); }
+    bool empty() const { return size() == 0; }
 
     /// Iterator for typed element access
     template <bool IsConst>
@@ -1070,8 +1967,8 @@ public:
     {
         friend class Array;
         using VecIter = std::conditional_t<IsConst,
-            typename std::vector<Element>::const_iterator,
-            typename std::vector<Element>::iterator>;
+            typename ElementVector::const_iterator,
+            typename ElementVector::iterator>;
         VecIter it_;
         explicit IteratorImpl(VecIter it) : it_(it) {}
     public:
@@ -1107,12 +2004,12 @@ public:
     using iterator = IteratorImpl<false>;
     using const_iterator = IteratorImpl<true>;
 
-    iterator begin() { return iterator(elements.begin()); }
-    iterator end() { return iterator(elements.end()); }
-    const_iterator begin() const { return const_iterator(elements.cbegin()); }
-    const_iterator end() const { return const_iterator(elements.cend()); }
-    const_iterator cbegin() const { return const_iterator(elements.cbegin()); }
-    const_iterator cend() const { return const_iterator(elements.cend()); }
+    iterator begin() { return iterator(loadedElements().begin()); }
+    iterator end() { return iterator(loadedElements().end()); }
+    const_iterator begin() const { return const_iterator(loadedElements().cbegin()); }
+    const_iterator end() const { return const_iterator(loadedElements().cend()); }
+    const_iterator cbegin() const { return const_iterator(loadedElements().cbegin()); }
+    const_iterator cend() const { return const_iterator(loadedElements().cend()); }
 };
 
 /**
@@ -1144,8 +2041,30 @@ class Map : public Object
 {
 public:
     Map() = default;
+
+    /// Copy constructor - allocates from MemoryResourceScope::current(), not from o's resource
     Map(Map const& o);
 
+    /// Move constructor - takes over the elements, memory resource and listeners of o
+    Map(Map&& o);
+
+    /**
+     * @brief Replaces the contents of this map with the elements of source, loaded on first access
+     *
+     * Intended for loading state: listeners are notified of the removal of the
+     * current elements, but not of the elements of source. Copies of a lazy
+     * map which was not modified share the source.
+     */
+    void setLazySource(std::shared_ptr<LazyElementSource<T> const> source);
+
+    /// Returns false if this is a lazy map whose elements were not constructed yet
+    bool isLoaded() const { return ! lazyPending; }
+
+    std::size_t compact() override;
+
+    /// Returns the memory resource used for the element storage
+    std::pmr::memory_resource* resource() const { return elements.get_allocator().resource(); }
+
     /// Returns the type_info for Map<T>
     std::type_info const& type() const override { return typeid(Map<T>); }
 
@@ -1170,8 +2089,13 @@ public:
     /// Returns a vector of type-erased references to all values (mutable version)
     std::vector<std::reference_wrapper<Value>> typeErasedFields() override;
 
+    /// Returns the number of values. Unlike size(), this constructs the elements of a lazy map.
+    std::size_t fieldCount() const override { return loadedElements().size(); }
+    Value const& fieldAt(std::size_t idx) const override;
+    Value& fieldAt(std::size_t idx) override;
+
     /// Returns the number of key-value pairs in the map
-    std::size_t size() const { return elements.size(); }
+    std::size_t size() const { return lazyPending ? lazySource->size() : elements.size(); }
 
     /**
      * @brief Add or update a key-value pair in the map
@@ -1193,6 +2117,12 @@ public:
      */
     void addElement(std::string_view key, T&& element);
 
+    /// @overload Add or update a key-value pair using a precomputed key
+    void addElement(MapKey key, T const& element);
+
+    /// @overload Add or update a key-value pair using a precomputed key (move version)
+    void addElement(MapKey key, T&& element);
+
     /**
      * @brief Remove a key-value pair from the map
      *
@@ -1203,6 +2133,9 @@ public:
      */
     bool removeElement(std::string_view key);
 
+    /// @overload Remove a key-value pair using a precomputed key
+    bool removeElement(MapKey const& key);
+
     /**
      * @brief Register a listener for map changes (token-based)
      *
@@ -1247,13 +2180,22 @@ public:
 
     // overridden base methods
     bool assign(Value const&) override;
+    std::uint64_t contentHash() const override;
     bool assignChild(std::string const&, Value const&) override;
     bool removeChild(std::string const&) override;
 
     friend bool operator==<>(Map<T> const&, Map<T> const&);
+    template <typename, typename> friend struct detail::ParallelContainerCopy;
 private:
     auto typeErasedFields_internal(this auto && self);
 
+    /// Returns an iterator to the element with the given key (or elements.end())
+    auto findElement(this auto && self, std::string_view key);
+    auto findElement(this auto && self, MapKey const& key);
+
+    /// Removes the element at it and notifies listeners
+    void removeElementAt(auto it);
+
     /**
      * @brief Internal wrapper for map values
      *
@@ -1270,16 +2212,16 @@ private:
         using Base = detail::BaseTypeFor<T>;
 
         /// Construct an element with a key and default value
-        Element(std::string_view fieldName_, Map& container_);
+        Element(MapKey key_, Map& container_);
 
         /// Copy constructor
         Element(Element const& o);
 
         /// Construct element with key and underlying value (copy)
-        Element(std::string_view fieldName_, Map& container_, T const& underlying_);
+        Element(MapKey key_, Map& container_, T const& underlying_);
 
         /// Construct element with key and underlying value (move)
-        Element(std::string_view fieldName_, Map& container_, T && underlying_);
+        Element(MapKey key_, Map& container_, T && underlying_);
 
         // Assignment operator
         Element& operator=(Element const&);
@@ -1296,7 +2238,8 @@ private:
     private:
         friend bool operator==<>(Map<T> const&, Map<T> const&);
         friend class Map<T>;
-        std::string fieldName;
+        template <typename, typename> friend struct detail::ParallelContainerCopy;
+        MapKey key;
 
         /// Initialize the element's parent pointer
         void init(Map& container_);
@@ -1304,11 +2247,22 @@ private:
 
     using MapListenerFunction = std::function<void(Operation, Map<T> const&, T const&, std::string_view)>;
 
-    void callListeners(Operation op, T const& newValue, std::string_view key) const;
+    void callListeners(Operation op, T const& newValue, std::string_view key);
+
+    using ElementVector = std::pmr::vector<Element>;
+
+    /// Constructs the elements of a lazy map if they were not constructed yet
+    void load() const;
+    ElementVector& loadedElements() const { load(); return elements; }
+
+    void childChanged() const override { std::atomic_ref(lazyModified).store(true, std::memory_order_relaxed); }
+    bool hasUnloadedChildren() const override { return lazyPending; }
 
-    std::vector<Element> elements;
-    mutable std::map<std::weak_ptr<ListenerToken::Impl>, MapListenerFunction, std::owner_less<std::weak_ptr<ListenerToken::Impl>>> mapListeners;
-    mutable std::vector<Value::ListenerBinding> managedMapListeners;
+    // mutable: elements of lazy maps are constructed on first (possibly const) access
+    mutable ElementVector elements { MemoryResourceScope::current() };
+    std::shared_ptr<LazyElementSource<T> const> lazySource;
+    mutable bool lazyPending = false, lazyModified = false;
+    mutable detail::ListenerList<MapListenerFunction> mapListeners;
 
 public:
     /// The typed element type (Fundamental<T> for primitive T, Record<T> for struct T)
@@ -1317,8 +2271,7 @@ public:
     /// Typed element access by key (asserts if key not found)
     ElementType& operator[](std::string_view key)
     {
-        auto it = std::find_if(elements.begin(), elements.end(),
-            [key](Element const& elem) { return elem.fieldName == key; });
+        auto it = findElement(key);
         assert(it != elements.end());
         return *it;
     }
@@ -1326,29 +2279,49 @@ public:
     /// Typed element access by key (const, asserts if key not found)
     ElementType const& operator[](std::string_view key) const
     {
-        auto it = std::find_if(elements.begin(), elements.end(),
-            [key](Element const& elem) { return elem.fieldName == key; });
+        auto it = findElement(key);
+        assert(it != elements.end());
+        return *it;
+    }
+
+    /// Typed element access by precomputed key (asserts if key not found)
+    ElementType& operator[](MapKey const& key)
+    {
+        auto it = findElement(key);
+        assert(it != elements.end());
+        return *it;
+    }
+
+    /// Typed element access by precomputed key (const, asserts if key not found)
+    ElementType const& operator[](MapKey const& key) const
+    {
+        auto it = findElement(key);
         assert(it != elements.end());
         return *it;
     }
 
     // Required to fix ambiguity with built-in operator[]
     template<typename U>
-    requires std::is_convertible_v<U, std::string_view>
+    requires (std::is_convertible_v<U, std::string_view> && ! std::is_same_v<std::remove_cvref_t<U>, MapKey>)
     ElementType& operator[](U&& key) { return (*this)[std::string_view(std::forward<U>(key))]; }
 
     template<typename U>
-    requires std::is_convertible_v<U, std::string_view>
+    requires (std::is_convertible_v<U, std::string_view> && ! std::is_same_v<std::remove_cvref_t<U>, MapKey>)
     ElementType const& operator[](U&& key) const { return (*this)[std::string_view(std::forward<U>(key))]; }
 
     /// Returns true if the map has no elements
-    bool empty() const { return elements.empty(); }
+    bool empty() const { return size() == 0; }
 
-    /// Returns true if the map contains an element with the given key
+    /// Returns true if the map contains an element with the given key (does not load lazy maps)
     bool contains(std::string_view key) const
     {
-        return std::find_if(elements.begin(), elements.end(),
-            [key](Element const& elem) { return elem.fieldName == key; }) != elements.end();
+        return lazyPending ? lazySource->find(key).has_value() : findElement(key) != elements.end();
+    }
+
+    /// Returns true if the map contains an element with the given precomputed key (does not load lazy maps)
+    bool contains(MapKey const& key) const
+    {
+        return lazyPending ? lazySource->find(key.view()).has_value() : findElement(key) != elements.end();
     }
 
     /// Iterator for typed element access
@@ -1357,8 +2330,8 @@ public:
     {
         friend class Map;
         using VecIter = std::conditional_t<IsConst,
-            typename std::vector<Element>::const_iterator,
-            typename std::vector<Element>::iterator>;
+            typename ElementVector::const_iterator,
+            typename ElementVector::iterator>;
         VecIter it_;
         explicit IteratorImpl(VecIter it) : it_(it) {}
     public:
@@ -1381,28 +2354,66 @@ public:
     using iterator = IteratorImpl<false>;
     using const_iterator = IteratorImpl<true>;
 
-    iterator begin() { return iterator(elements.begin()); }
-    iterator end() { return iterator(elements.end()); }
-    const_iterator begin() const { return const_iterator(elements.cbegin()); }
-    const_iterator end() const { return const_iterator(elements.cend()); }
-    const_iterator cbegin() const { return const_iterator(elements.cbegin()); }
-    const_iterator cend() const { return const_iterator(elements.cend()); }
+    iterator begin() { return iterator(loadedElements().begin()); }
+    iterator end() { return iterator(loadedElements().end()); }
+    const_iterator begin() const { return const_iterator(loadedElements().cbegin()); }
+    const_iterator end() const { return const_iterator(loadedElements().cend()); }
+    const_iterator cbegin() const { return const_iterator(loadedElements().cbegin()); }
+    const_iterator cend() const { return const_iterator(loadedElements().cend()); }
 
     /// Find an element by key
-    iterator find(std::string_view key)
-    {
-        return iterator(std::find_if(elements.begin(), elements.end(),
-            [key](Element const& elem) { return elem.fieldName == key; }));
-    }
+    iterator find(std::string_view key) { return iterator(findElement(key)); }
 
     /// Find an element by key (const)
-    const_iterator find(std::string_view key) const
-    {
-        return const_iterator(std::find_if(elements.begin(), elements.end(),
-            [key](Element const& elem) { return elem.fieldName == key; }));
-    }
+    const_iterator find(std::string_view key) const { return const_iterator(findElement(key)); }
+
+    /// Find an element by precomputed key
+    iterator find(MapKey const& key) { return iterator(findElement(key)); }
+
+    /// Find an element by precomputed key (const)
+    const_iterator find(MapKey const& key) const { return const_iterator(findElement(key)); }
 };
 
+/**
+ * @brief Hooks policy of a Field without hooks (the default)
+ *
+ * A Field can react to its own changes with hooks which are known at compile
+ * time, e.g. to keep a derived field up to date. The hooks policy is a type
+ * with a static member function changed(field, parent), where parent is the
+ * record containing the field:
+ *
+ * @code
+ * struct UpdateArea;
+ *
+ * struct Rect {
+ *     Field<float, "width", UpdateArea>  width;
+ *     Field<float, "height", UpdateArea> height;
+ *     Field<float, "area">               area;
+ * };
+ *
+ * struct UpdateArea {
+ *     template <typename FieldType>
+ *     static void changed(FieldType&, Object* parent)
+ *     {
+ *         auto& rect = static_cast<Record<Rect>&>(*parent);
+ *         rect->area = rect->width() * rect->height();
+ *     }
+ * };
+ * @endcode
+ *
+ * A hook runs after a new value of its field is stored, or a descendant of a
+ * record field changed, and before any listener is notified. Dynamic listeners
+ * keep working alongside hooks. Hooks run for every write, however it is made.
+ * Assigning to the field calls them directly. Writes which do not know the
+ * type of the field (Value::visit(), assignChild(), diffs, decoders or
+ * snapshots) reach them through a table of the enclosing record, and skip the
+ * walk to it if no record above the written value has hooks. When the enclosing record is
+ * assigned as a whole, the hooks of all its fields run once every field is
+ * stored. Fields outside of a record do not run hooks. Only leaf and record
+ * fields support hooks.
+ */
+struct NoFieldHooks {};
+
 /**
  * @brief Named field wrapper for use as struct members
  *
@@ -1417,6 +2428,7 @@ public:
  *
  * @tparam T The underlying value type
  * @tparam Name Compile-time string literal for the field name
+ * @tparam Hooks Statically dispatched reactions to changes of the field, see NoFieldHooks
  *
  * @code
  * struct Point {
@@ -1430,12 +2442,27 @@ public:
  * };
  * @endcode
  */
-template <typename T, fixstr::fixed_string Name>
+template <typename T, fixstr::fixed_string Name, typename Hooks>
 class Field : public detail::BaseTypeFor<T>
 {
 public:
     using Base = detail::BaseTypeFor<T>;
 
+    /// The compile-time field name as specified in the template parameter
+    static constexpr std::string_view kFieldName = std::string_view(Name);
+
+    /// The hooks policy of the field (see NoFieldHooks)
+    using HooksPolicy = Hooks;
+
+    /// True if the field has hooks (see NoFieldHooks)
+    static constexpr auto kHasHooks = ! std::is_same_v<Hooks, NoFieldHooks>;
+
+    /// True for computed fields (see Computed)
+    static constexpr bool kIsComputed = false;
+
+    static_assert((! kHasHooks) || std::is_base_of_v<Fundamental<T>, Base>,
+                  "Field hooks are only supported for leaf and record fields");
+
     /// Default constructor - creates a Field with default-initialized value
     Field() = default;
 
@@ -1449,6 +2476,107 @@ public:
     std::string fieldname() const override;
 };
 
+/**
+ * @brief A field whose value is computed from other fields of the same struct
+ *
+ * Function is a default constructible callable taking one argument per
+ * dependency, in the order of Dependencies, which name fields of the
+ * enclosing struct. Leaf and record dependencies are passed as their
+ * underlying value, Array and Map dependencies as the container:
+ *
+ * @code
+ * struct Width {
+ *     float operator()(Point const& start, Point const& finish) const { return finish.x() - start.x(); }
+ * };
+ *
+ * struct Span {
+ *     Field<Point, "start">                           start;
+ *     Field<Point, "finish">                          finish;
+ *     Computed<float, "width", Width, "start", "finish"> width;
+ * };
+ * @endcode
+ *
+ * The value is computed lazily: writing a dependency or one of its
+ * descendants only marks the value as out of date, and the next read computes
+ * it, so a burst of writes costs a single evaluation. Reads through the typed
+ * field (operator(), conversion to T), through the enclosing record (fields(),
+ * visitFields(), visitField(), fieldAt(), getchild(), ...), content hashes and
+ * the encoders all see the up-to-date value; load() and reads of the bare
+ * Fundamental<T> return the last computed one. The dependencies are looked up
+ * by name at compile time.
+ *
+ * A write of a dependency stamps the field (see changedSince()) but does not
+ * notify its listeners: listen to the dependencies or to the enclosing record.
+ * A value assigned to the field (e.g. when decoding) holds until a dependency
+ * changes. Outside of a record the value is never computed.
+ */
+template <typename T, fixstr::fixed_string Name, typename Function, fixstr::fixed_string... Dependencies>
+class Computed : public Field<T, Name>
+{
+public:
+    using Base = Field<T, Name>;
+
+    static_assert(Value::isOpaque<T>(), "Computed fields must be leaves");
+    static_assert(sizeof...(Dependencies) >= 1, "A computed field needs at least one dependency");
+    static_assert(std::tuple_size_v<typename detail::call_arguments<Function>::type> == sizeof...(Dependencies),
+                  "The function of a computed field must take one argument per dependency");
+
+    /// Names of the fields the value is computed from, in the order of Function's arguments
+    static constexpr std::array<std::string_view, sizeof...(Dependencies)> kDependencies = {{ std::string_view(Dependencies)... }};
+
+    /// True for computed fields
+    static constexpr bool kIsComputed = true;
+
+    /// Default constructor - the enclosing record computes the value
+    Computed() = default;
+
+    /// Copy constructor
+    Computed(Computed const&) = default;
+
+    /// Move constructor
+    Computed(Computed&&) = default;
+
+    using Base::operator=;
+
+    /// Copy assignment operator, the value holds until a dependency changes
+    Computed& operator=(Computed const& o);
+
+    /// Move assignment operator, the value holds until a dependency changes
+    Computed& operator=(Computed&& o);
+
+    /// Calls Function with the dependency fields (leaves and records as their underlying value, containers as the container)
+    template <typename... Fields>
+    static T compute(Fields const&... dependencies);
+
+    /// Returns the value, computing it first if a dependency changed since the last read
+    T const& operator()() const { refresh(); return Base::operator()(); }
+
+    /// Implicit conversion to the underlying type, computing the value first if a dependency changed since the last read
+    operator T() const { refresh(); return Base::operator()(); }
+
+    // overridden base methods
+    std::uint64_t contentHash() const override { refresh(); return Base::contentHash(); }
+
+private:
+    template <typename> friend class Record;
+
+    template <typename Arg, typename FieldType>
+    static decltype(auto) argument(FieldType const& field);
+
+    /// Lets the enclosing record compute the value if it is out of date
+    void refresh() const
+    {
+        if (dirty && this->parent != nullptr)
+            this->parent->fieldHooks->refresh(*this->parent);
+    }
+
+    /// Stores a computed value without notifying
+    void storeComputed(T const& value) { this->store(value); }
+
+    // set by the enclosing record when a dependency changed, cleared when the value is computed or written
+    bool dirty = false;
+};
+
 //=============================================================================
 // MetaType system - compile-time type reflection without instances
 //=============================================================================
@@ -1502,6 +2630,29 @@ public:
     /// Returns true if this is a Map<T> type
     virtual bool isMap() const { return false; }
 
+    /**
+     * @brief Returns the name of the type
+     *
+     * Built-in leaf types have canonical names ("int32", "uint64", "string", "ID", ...),
+     * containers are named "Array<element>" and "Map<element>". Records use the name
+     * given to DYNAMIC_REGISTER_RECORD, or the compiler generated name of the struct.
+     */
+    virtual std::string_view name() const = 0;
+
+    /**
+     * @brief Returns the structural schema hash of the type
+     *
+     * The hash covers the kind of the type, the names and order of record fields and,
+     * recursively, the schema of every field and container element. It does not cover
+     * the record's own name. Leaves also hash their size and alignment (and, for floating
+     * point types, their precision and exponent range), so the hash is identical across
+     * builds and platforms only where every leaf has the same in-memory representation:
+     * e.g. schemas with long double or wchar_t leaves may differ between platforms, and
+     * such peers have to use WireEncoding::tagged. Extra fundamental types registered via
+     * ExtraFundamentalTypes hash the compiler generated type name, which is not portable.
+     */
+    virtual std::uint64_t schemaHash() const = 0;
+
     /**
      * @brief Returns field descriptors for Record types
      *
@@ -1551,6 +2702,48 @@ public:
 template <typename T>
 MetaType const& metaTypeOf();
 
+/**
+ * @brief Stable name of a record type, see DYNAMIC_REGISTER_RECORD
+ *
+ * Specializations provide a static constexpr std::string_view value.
+ */
+template <typename T>
+struct RecordName;
+
+/**
+ * @brief Global registry of record MetaTypes
+ *
+ * Every record type is added automatically during static initialization once
+ * metaTypeOf<T>() is instantiated anywhere in the program (which happens for
+ * every Record<T> and every Field<T, Name> with struct T). Use
+ * DYNAMIC_REGISTER_RECORD to register types which are otherwise unused, and to
+ * give them a stable name. Other MetaTypes can be added explicitly with add().
+ *
+ * Lookups are O(1) and thread-safe.
+ *
+ * @code
+ * if (auto const* meta = MetaTypeRegistry::findBySchemaHash(header.schemaHash))
+ *     auto value = meta->construct();
+ * @endcode
+ */
+class MetaTypeRegistry
+{
+public:
+    MetaTypeRegistry() = delete;
+
+    /// Registers meta under its name and schema hash (the first registration of a name or hash wins)
+    static void add(MetaType const& meta);
+
+    /// Returns the MetaType registered under name, or nullptr
+    static MetaType const* findByName(std::string_view name);
+
+    /// Returns the MetaType registered with the given schema hash, or nullptr
+    static MetaType const* findBySchemaHash(std::uint64_t hash);
+
+    /// Returns all registered MetaTypes in registration order
+    static std::vector<MetaType const*> registered();
+};
+
 // Equality and stream output operators
 bool operator==(ID const& lhs, ID const& rhs);
 std::ostream& operator<<(std::ostream& o, ID const& id);
@@ -1559,6 +2752,29 @@ std::ostream& operator<<(std::ostream& o, dynamic::Object const& x);
 std::ostream& operator<<(std::ostream& o, dynamic::Invalid const& x);
 } // namespace dynamic
 
+#define DYNAMIC_CONCAT_IMPL(a, b) a##b
+#define DYNAMIC_CONCAT(a, b) DYNAMIC_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Registers a record type with the MetaTypeRegistry under a stable name
+ *
+ * Must be used at global namespace scope, after the definition of Type and
+ * before Type is used with Record<> or metaTypeOf<>():
+ * @code
+ * struct Point { Field<float, "x"> x; Field<float, "y"> y; };
+ * DYNAMIC_REGISTER_RECORD(Point, "geometry.Point")
+ * @endcode
+ */
+#define DYNAMIC_REGISTER_RECORD(Type, Name)                                                   \
+    template <> struct dynamic::RecordName<Type> { static constexpr std::string_view value = Name; }; \
+    [[maybe_unused]] static dynamic::MetaType const& DYNAMIC_CONCAT(dynamicRecordRegistration_, __COUNTER__) = dynamic::metaTypeOf<Type>();
+
+template <>
+struct std::hash<dynamic::MapKey>
+{
+    std::size_t operator()(dynamic::MapKey const& key) const noexcept { return key.hash(); }
+};
+
 // std::formatter specializations
 template <>
 struct std::formatter<dynamic::Object> : std::formatter<std::string>
@@ -1592,8 +2808,8 @@ struct std::formatter<dynamic::Value, CharT>
 template <typename T, typename CharT>
 struct std::formatter<dynamic::Fundamental<T>, CharT> : std::formatter<dynamic::Value, CharT> {};
 
-template <typename T, fixstr::fixed_string Name>
-struct std::formatter<dynamic::Field<T, Name>> : std::formatter<dynamic::Value> {};
+template <typename T, fixstr::fixed_string Name, typename Hooks>
+struct std::formatter<dynamic::Field<T, Name, Hooks>> : std::formatter<dynamic::Value> {};
 
 template <>
 struct std::formatter<dynamic::ID> : std::formatter<std::string>
@@ -3,6 +3,121 @@
 namespace dynamic
 {
 
+//=============================================================================
+// ListenerList implementations
+//=============================================================================
+namespace detail
+{
+template <typename Function>
+ListenerList<Function>::ListenerList(ListenerList&& o) noexcept
+    : entries(o.entries.exchange(nullptr)),
+      count(o.count.exchange(0)),
+      hasRetired(o.hasRetired.exchange(false)),
+      retired(std::move(o.retired)),
+      bindings(std::move(o.bindings))
+{}
+
+template <typename Function>
+ListenerList<Function>::~ListenerList()
+{
+    delete entries.load();
+}
+
+template <typename Function>
+ListenerToken ListenerList<Function>::add(Function function)
+{
+    ListenerToken token(ListenerToken::private_constructor_t{});
+    auto next = std::make_unique<Entries>();
+
+    std::lock_guard lock(mutex);
+
+    if (auto const* current = entries.load())
+    {
+        next->reserve(current->size() + 1);
+        std::copy_if(current->begin(), current->end(), std::back_inserter(*next),
+                     [] (Entry const& entry) { return ! entry.token.expired(); });
+    }
+
+    next->push_back({ token.token, std::make_shared<Function const>(std::move(function)) });
+    count.store(next->size(), std::memory_order_release);
+
+    if (auto const* previous = entries.exchange(next.release()))
+    {
+        retired.emplace_back(previous);
+        hasRetired.store(true);
+    }
+
+    reclaim();
+    return token;
+}
+
+template <typename Function>
+void ListenerList<Function>::add(std::weak_ptr<void> context, Function function)
+{
+    addWhile([context = std::move(context)] { return ! context.expired(); }, std::move(function));
+}
+
+template <typename Function>
+void ListenerList<Function>::addWhile(std::function<bool()> alive, Function function)
+{
+    auto token = add(std::move(function));
+
+    std::lock_guard lock(mutex);
+    std::erase_if(bindings, [] (Binding const& binding) { return ! binding.alive(); });
+    bindings.push_back({ std::move(alive), std::move(token) });
+}
+
+template <typename Function>
+void ListenerList<Function>::reclaim() const
+{
+    // seq_cst pairs with forEach(): a dispatch which was not counted here loads the current array
+    if (dispatching.load() == 0)
+    {
+        retired.clear();
+        hasRetired.store(false);
+    }
+}
+
+template <typename Function>
+void ListenerList<Function>::endDispatch() const
+{
+    if (dispatching.fetch_sub(1) != 1 || ! hasRetired.load())
+        return;
+
+    // a dispatch never waits for a registration: if one holds the mutex, it reclaims instead
+    if (std::unique_lock lock(mutex, std::try_to_lock); lock.owns_lock())
+        reclaim();
+}
+
+template <typename Function>
+template <typename... Args>
+void ListenerList<Function>::call(Args const&... args) const
+{
+    forEach([&args...] (Function const& function) { function(args...); });
+}
+
+template <typename Function>
+template <typename Visitor>
+void ListenerList<Function>::forEach(Visitor && visitor) const
+{
+    // no need to register as a reader while no listener was ever added
+    if (entries.load(std::memory_order_relaxed) == nullptr)
+        return;
+
+    dispatching.fetch_add(1);
+    auto const done = cxxutils::callAtEndOfScope(this, [] (ListenerList const* list) { list->endDispatch(); });
+
+    for (auto const& entry : *entries.load())
+    {
+        // the token may have expired since the array was published, e.g. by a previous listener of this dispatch
+        if (entry.token.expired())
+            continue;
+
+        visitor(*entry.function);
+    }
+}
+} // namespace detail
+
 //=============================================================================
 // Value implementations
 //=============================================================================
@@ -13,72 +128,64 @@ auto Value::visit(this auto&& self, Lambda && lambda) -> decltype(auto)
 
     using NonPrimitiveArgumentTypes = std::tuple<Invalid, Object>;
     using AllArgumentTypes = decltype(std::tuple_cat(std::declval<NonPrimitiveArgumentTypes>(), std::declval<SupportedFundamentalTypes>()));
-    using AllArgumentRefs = std::conditional_t<kIsConst, detail::transform_tuple<AllArgumentTypes, detail::add_const_lvalue_ref>::type,
-                                                         detail::transform_tuple<AllArgumentTypes, detail::add_lvalue_ref>::type>;
+    using AllArgumentRefs = std::conditional_t<kIsConst, typename detail::transform_tuple<AllArgumentTypes, detail::add_const_lvalue_ref>::type,
+                                                         typename detail::transform_tuple<AllArgumentTypes, detail::add_lvalue_ref>::type>;
     using SupportedArgumentsByLambda = decltype(detail::filter_tuple<detail::DoesLambdaSupportType<Lambda>::template Predicate>(std::declval<AllArgumentRefs>()));
     static_assert(std::tuple_size_v<SupportedArgumentsByLambda> >= 1, "Your lambda must be callable with at least one of the types in SupportedFundamentalTypes");
 
     using LambdaReturnTypes = detail::transform_tuple<SupportedArgumentsByLambda, detail::BindFirst<std::invoke_result_t, Lambda>::template Result>::type;
     using LambdaReturnType = detail::apply_tuple<std::common_type, LambdaReturnTypes>::type::type;
 
-    using InvalidRef = std::conditional_t<kIsConst, Invalid const, Invalid>&;
-    using TypeErasedObjectRef = std::conditional_t<kIsConst, Object const, Object>&;
+    using ValueRef = std::conditional_t<kIsConst, Value const, Value>&;
+    using Dispatcher = LambdaReturnType (*)(ValueRef, Lambda&);
 
-    if constexpr (std::is_invocable_v<Lambda, InvalidRef>)
+    // One entry per type tag: the entries' order must match kInvalidTypeIndex,
+    // kObjectTypeIndex and kFirstFundamentalTypeIndex + index in SupportedFundamentalTypes
+    static constexpr auto kJumpTable = std::invoke([] <typename... Types> (std::type_identity<std::tuple<Types...>>)
     {
-        if (! self.isValid())
-            return lambda(static_cast<InvalidRef>(self));
-    }
+        return std::array<Dispatcher, sizeof...(Types)> {{ &Value::visitAs<Types, LambdaReturnType, ValueRef, Lambda>... }};
+    }, std::type_identity<AllArgumentTypes>());
 
-    if constexpr (std::is_invocable_v<Lambda, TypeErasedObjectRef>)
-    {
-        if (self.isStruct())
-            return lambda(static_cast<TypeErasedObjectRef>(self));
-    }
+    ValueRef value = self;
+    assert(value.typeIndex < kJumpTable.size());
+    return kJumpTable[value.typeIndex](value, lambda);
+}
 
-    return std::visit([lambda_ = std::move(lambda), &self] <typename T> (std::reference_wrapper<T> v) -> LambdaReturnType
+template <typename Arg, typename ReturnType, typename ValueRef, typename Lambda>
+ReturnType Value::visitAs(ValueRef self, Lambda& lambda)
+{
+    static constexpr auto kIsConst = std::is_const_v<std::remove_reference_t<ValueRef>>;
+    using ArgRef = std::conditional_t<kIsConst, Arg const, Arg>&;
+
+    if constexpr (std::is_invocable_v<Lambda&, ArgRef>)
     {
-        if constexpr (std::is_invocable_v<Lambda, T&>)
+        if constexpr (std::is_same_v<Arg, Invalid> || std::is_same_v<Arg, Object>)
         {
-            using Type = std::remove_const_t<T>;
-            static constexpr auto kIsPrimitive = (! std::is_same_v<Object, Type>) && (! std::is_same_v<Invalid, Type>);
-
-            if constexpr (kIsPrimitive && (! kIsConst))
-            {
-                Type copy(v.get());
-
-                if constexpr (! std::is_void_v<std::invoke_result_t<Lambda, T&>>)
-                {
-                    auto returnValue = lambda_(copy);
-                    static_cast<Fundamental<Type>&>(self) = copy;
-                    return returnValue;
-                }
-                else
-                {
-                    lambda_(copy);
-                    static_cast<Fundamental<Type>&>(self) = copy;
-                    if constexpr (! std::is_void_v<LambdaReturnType>)
-                    {
-                        assert(false);
-                        // this should never reach this code: crash !
-                        return *reinterpret_cast<LambdaReturnType*>(1);
-                    }
-                    else
-                        return;
-                }
-            }
+            return lambda(static_cast<ArgRef>(self));
+        }
+        else
+        {
+            using FundamentalRef = std::conditional_t<kIsConst, Fundamental<Arg> const, Fundamental<Arg>>&;
+            auto& fundamental = static_cast<FundamentalRef>(self);
 
-            return lambda_(v.get());
+            if constexpr (kIsConst)
+                return lambda(fundamental.underlying);
+            else
+                return fundamental.visitInPlace(lambda);
         }
+    }
+    else
+    {
+        (void)self;
+        (void)lambda;
 
-        if constexpr (! std::is_void_v<LambdaReturnType>)
+        if constexpr (! std::is_void_v<ReturnType>)
         {
             assert(false);
             // this should never reach this code: crash !
-            return *reinterpret_cast<LambdaReturnType*>(1);
+            return *reinterpret_cast<ReturnType*>(1);
         }
-        
-    }, self.visit_helper());
+    }
 }
 
 template <typename T>
@@ -87,6 +194,9 @@ constexpr bool Value::isOpaque()
     if constexpr (requires(T t) { []<typename U>(Map<U>&){}(t); })
         return false;
 
+    if constexpr (requires(T t) { []<typename U, std::size_t N>(ConcurrentMap<U, N>&){}(t); })
+        return false;
+
     if constexpr (requires(T t) { []<typename U>(Array<U>&){}(t); })
         return false;
 
@@ -102,11 +212,13 @@ constexpr bool Value::isOpaque()
 template <std::invocable<ID const&, Object::Operation, Object const&, Value const&> Lambda>
 ListenerToken Object::addChildListener(Lambda && lambda)
 {
-    ListenerToken token(ListenerToken::private_constructor_t{});
+    return childListeners.add(std::move(lambda));
+}
 
-    // Add the listener to the vector
-    childListeners.emplace(std::weak_ptr<ListenerToken::Impl>(token.token), std::move(lambda));
-    return token;
+template <std::invocable<Object const&, std::string_view, Object::Operation, Value const&> Lambda>
+ListenerToken Object::addPathFreeChildListener(Lambda && lambda)
+{
+    return pathFreeChildListeners.add(std::move(lambda));
 }
 
 template <class Context, std::invocable<ID const&, Object::Operation, Object const&, Value const&> Lambda>
@@ -118,13 +230,6 @@ void Object::addChildListener(std::enable_shared_from_this<Context>* context, La
 template <class Context, std::invocable<ID const&, Object::Operation, Object const&, Value const&> Lambda>
 void Object::addChildListener(std::weak_ptr<Context>&& context, Lambda && lambda)
 {
-    // Clean up expired managed listeners first
-    managedChildListeners.erase(
-        std::remove_if(managedChildListeners.begin(), managedChildListeners.end(),
-            [](auto const& ml) { return ml.context.expired(); }),
-        managedChildListeners.end()
-    );
-
     // Capture the weak_ptr and wrap the lambda
     auto wrappedLambda = [weakCtx = context, userLambda = std::move(lambda)]
                         (ID const& id, Operation op, Object const& parent_, Value const& value)
@@ -133,22 +238,46 @@ void Object::addChildListener(std::weak_ptr<Context>&& context, Lambda && lambda
             userLambda(id, op, parent_, value);
     };
 
-    // Add the token-based listener and store the token
-    auto token = addChildListener(std::move(wrappedLambda));
-    managedChildListeners.push_back({std::weak_ptr<void>(context), std::move(token)});
+    // The list keeps the listener until the context expires
+    childListeners.add(std::weak_ptr<void>(context), std::move(wrappedLambda));
+}
+
+template <std::invocable<ID const&, Value const&> Lambda>
+ListenerToken Object::addCoalescedChildListener(std::chrono::nanoseconds interval, Lambda && lambda)
+{
+    // interval is added to time points: clamp it so that the sum cannot overflow
+    auto const period = std::min(std::chrono::duration_cast<Clock::duration>(interval), Clock::duration(std::numeric_limits<Clock::rep>::max() / 2));
+    auto const tickOnly = interval == std::chrono::nanoseconds::max();
+
+    auto deliver = [userLambda = std::move(lambda), lastVersion = subtreeVersion(), due = Clock::now() + period, period, tickOnly]
+                   (Object const& object, Clock::time_point now, bool flush) mutable
+    {
+        if (! flush && (tickOnly || now < due))
+            return tickOnly ? Clock::time_point::max() : due;
+
+        // update the state first: the listener may change the tree and thus re-enter
+        auto const since = std::exchange(lastVersion, object.subtreeVersion());
+        due = now + period;
+
+        if (since != lastVersion)
+            for (auto const& [path, value] : object.changedSince(since))
+                userLambda(path, value);
+
+        return tickOnly ? Clock::time_point::max() : due;
+    };
+
+    auto& list = coalescedChildListeners();
+    auto token = list.listeners.add(std::move(deliver));
+
+    // let the next change ask all listeners for their next delivery
+    list.nextDelivery.store(std::numeric_limits<Clock::rep>::min(), std::memory_order_relaxed);
+    return token;
 }
 
 #if JUCE_SUPPORT
 template <class ComponentType, std::invocable<ID const&, Object::Operation, Object const&, Value const&> Lambda>
 void Object::addChildListener(ComponentType* context, Lambda && lambda) requires std::is_base_of_v<juce::Component, ComponentType>
 {
-    // Clean up expired managed listeners first
-    managedChildListeners.erase(
-        std::remove_if(managedChildListeners.begin(), managedChildListeners.end(),
-            [](auto const& ml) { return ml.context.expired(); }),
-        managedChildListeners.end()
-    );
-
     // Create a SafePointer and wrap the lambda
     juce::Component::SafePointer<ComponentType> safeContext(context);
     auto wrappedLambda = [safeContext, userLambda = std::move(lambda)]
@@ -158,11 +287,8 @@ void Object::addChildListener(ComponentType* context, Lambda && lambda) requires
             userLambda(id, op, parent_, value);
     };
 
-    // Add the token-based listener and store the token
-    // Note: We can't use weak_ptr for JUCE components, so we track expiry differently
-    // by checking the SafePointer in the wrapped lambda
-    auto token = addChildListener(std::move(wrappedLambda));
-    managedChildListeners.push_back({std::weak_ptr<void>(), std::move(token)});
+    // JUCE components have no weak_ptr: the SafePointer tells when to drop the listener
+    childListeners.addWhile([safeContext] { return safeContext.getComponent() != nullptr; }, std::move(wrappedLambda));
 }
 #endif
 
@@ -171,13 +297,12 @@ auto Object::operator()(this auto&& self, std::string_view fldname)
                           Value const&,
                           Value&>
 {
-    auto flds = self.typeErasedFields();
-    auto it = std::find_if(flds.begin(), flds.end(), [&fldname] (auto const& fld) { return fld.get().fieldname() == fldname; });
-
-    if (it == flds.end()) // no field with this name?
-        return Value::kInvalid;
+    for (auto& fld : self.fieldRange())
+        if (fld.fieldname() == fldname)
+            return fld;
 
-    return it->get();
+    // no field with this name
+    return Value::kInvalid;
 }
 
 auto Object::getchild(this auto& self, ID subid) -> std::conditional_t<std::is_const_v<std::remove_reference_t<decltype(self)>>, Value const&, Value&>
@@ -206,15 +331,159 @@ auto Object::getchild(this auto& self, ID subid) -> std::conditional_t<std::is_c
     return fld;
 }
 
+//=============================================================================
+// Content hash helpers
+//=============================================================================
+
+namespace detail
+{
+
+/// Hash of a leaf value, see Value::contentHash()
+template <typename T>
+std::uint64_t leaf_content_hash(T const& value)
+{
+    if constexpr (std::is_same_v<T, std::string>)
+    {
+        return fnv1a(value);
+    }
+    else if constexpr (std::is_same_v<T, ID>)
+    {
+        auto hash = fnv1a(value.size(), kFnvOffsetBasis);
+
+        for (auto const& element : value)
+            hash = fnv1a(element, fnv1a(element.size(), hash));
+
+        return hash;
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        // +0.0 and -0.0 compare equal and must hash equal
+        auto const normalized = value == T(0) ? 0.0 : static_cast<double>(value);
+        return fnv1a(std::bit_cast<std::uint64_t>(normalized), kFnvOffsetBasis);
+    }
+    else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+    {
+        return fnv1a(static_cast<std::uint64_t>(value), kFnvOffsetBasis);
+    }
+    else if constexpr (requires { { std::hash<T>{}(value) } -> std::convertible_to<std::size_t>; })
+    {
+        return fnv1a(static_cast<std::uint64_t>(std::hash<T>{}(value)), kFnvOffsetBasis);
+    }
+    else if constexpr (std::has_unique_object_representations_v<T>)
+    {
+        return fnv1a(std::string_view(reinterpret_cast<char const*>(&value), sizeof(T)));
+    }
+    else
+    {
+        // the value can't be hashed: all values of T hash equal, which is why
+        // has_exact_content_hash never lets such leaves be skipped by their hash
+        return SchemaHash<T>::value;
+    }
+}
+
+/**
+ * @brief Compares two leaf values
+ *
+ * Uses operator== if available and compares the bytes of types with unique
+ * object representations otherwise. Any other leaf without operator== never
+ * compares equal, so that changes to it are never missed (consistent with
+ * Fundamental<T>::isEqual).
+ */
+template <typename T>
+bool leaf_equal(T const& a, T const& b)
+{
+    if constexpr (requires { { a == b } -> std::convertible_to<bool>; })
+        return a == b;
+    else if constexpr (std::has_unique_object_representations_v<T>)
+        return std::memcmp(&a, &b, sizeof(T)) == 0;
+    else
+        return false;
+}
+
+/**
+ * @brief Compares two reflection wrappers of T (Fundamental<T>, Record<T> or the container itself) by value
+ *
+ * Records are compared field by field and leaves with leaf_equal().
+ */
+template <typename T, typename Wrapper>
+bool values_equal(Wrapper const& a, Wrapper const& b)
+{
+    if constexpr (Value::isOpaque<T>())
+    {
+        return leaf_equal(a(), b());
+    }
+    else if constexpr (std::is_base_of_v<Record<T>, Wrapper>)
+    {
+        auto const aFields = a.fields();
+        auto const bFields = b.fields();
+
+        return std::invoke([&] <std::size_t... Is> (std::index_sequence<Is...>)
+        {
+            return (values_equal<field_value_type_t<std::remove_cvref_t<std::tuple_element_t<Is, decltype(aFields)>>>>(std::get<Is>(aFields), std::get<Is>(bFields)) && ...);
+        }, std::make_index_sequence<std::tuple_size_v<decltype(aFields)>>());
+    }
+    else
+    {
+        return static_cast<BaseTypeFor<T> const&>(a) == static_cast<BaseTypeFor<T> const&>(b);
+    }
+}
+
+/**
+ * @brief True if the content hash of T covers every leaf value in full
+ *
+ * Only then may equal hashes be taken as (probable) equality, see DiffMode::hashed.
+ * Even then, 64-bit collisions are possible and NaNs hash equal but compare unequal.
+ * std::hash is not taken into account: it may hash only part of a value.
+ */
+template <typename T>
+struct has_exact_content_hash
+{
+    static constexpr bool compute()
+    {
+        if constexpr (Value::isOpaque<T>())
+        {
+            // long double is hashed with double precision
+            return (! std::is_same_v<T, long double>) &&
+                   (std::is_same_v<T, std::string> || std::is_same_v<T, ID> || std::is_arithmetic_v<T> || std::is_enum_v<T> ||
+                    (std::has_unique_object_representations_v<T> && ! requires (T const& leaf) { std::hash<T>{}(leaf); }));
+        }
+        else
+        {
+            return std::invoke([] <typename... Fields> (std::type_identity<std::tuple<Fields...>>)
+            {
+                return (has_exact_content_hash<field_value_type_t<Fields>>::value && ...);
+            }, std::type_identity<typename Record<T>::FieldsAsTuple>());
+        }
+    }
+
+    static constexpr bool value = compute();
+};
+
+template <typename T>
+struct has_exact_content_hash<Array<T>> : has_exact_content_hash<T> {};
+
+template <typename T>
+struct has_exact_content_hash<Map<T>> : has_exact_content_hash<T> {};
+
+} // namespace detail
+
 //=============================================================================
 // Fundamental implementations
 //=============================================================================
 
 template <typename T>
-Fundamental<T>::Fundamental() : underlying() { }
+Fundamental<T>::Fundamental() : underlying()
+{
+    if constexpr (kIsOpaque)
+        Value::typeIndex = kTypeIndex;
+}
 
 template <typename T>
-Fundamental<T>::Fundamental(T underlying_) : underlying(underlying_) {}
+Fundamental<T>::Fundamental(T underlying_) : underlying(underlying_)
+{
+    if constexpr (kIsOpaque)
+        Value::typeIndex = kTypeIndex;
+}
 
 template <typename T>
 Fundamental<T>::Fundamental(Fundamental const& o) : Value(o), underlying(o.underlying) {}
@@ -256,48 +525,31 @@ Fundamental<T>& Fundamental<T>::operator=(Fundamental && newValue)
 }
 
 template <typename T>
-void Fundamental<T>::set(T const& newValue)
+bool Fundamental<T>::isEqual(T const& a, T const& b)
 {
-    if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
-    {
-        if (std::fabs(underlying - newValue) <= std::numeric_limits<T>::epsilon())
-            return;
-    }
-    else if constexpr (requires(T const& a, T const& b) { { a == b } -> std::convertible_to<bool>; })
-    {
-        if (underlying == newValue)
-            return;
-    }
+    if constexpr (std::is_floating_point_v<T>)
+        return std::fabs(a - b) <= std::numeric_limits<T>::epsilon();
+    else if constexpr (requires { { a == b } -> std::convertible_to<bool>; })
+        return a == b;
+    else
+        return false; // assume changed for types without operator==
+}
 
-    {
-        ++Value::recursiveListenerDisabler;
-        auto raiiDecrementer = cxxutils::callAtEndOfScope(std::false_type(),
-                                                          [] (std::false_type)
-                                                          {
-                                                              --Value::recursiveListenerDisabler;
-                                                          });
-        underlying = newValue;
-    }
+template <typename T>
+void Fundamental<T>::set(T const& newValue)
+{
+    if (isEqual(underlying, newValue))
+        return;
 
-    if (Value::recursiveListenerDisabler == 0)
-        callListeners();
+    store(newValue);
+    notifyChanged();
 }
 
 template <typename T>
 void Fundamental<T>::set(T && newValue)
 {
-    {
-        ++Value::recursiveListenerDisabler;
-        auto raiiDecrementer = cxxutils::callAtEndOfScope(std::false_type(),
-                                                          [] (std::false_type)
-                                                          {
-                                                              --Value::recursiveListenerDisabler;
-                                                          });
-        underlying = std::move(newValue);
-    }
-
-    if (Value::recursiveListenerDisabler == 0)
-        callListeners();
+    store(std::move(newValue));
+    notifyChanged();
 }
 
 template <typename T>
@@ -317,18 +569,169 @@ void Fundamental<T>::mutate(Lambda && lambda)
 
     if (changed)
     {
+        store(std::move(copy));
+        notifyChanged();
+    }
+}
+
+template <typename T>
+template <typename Lambda>
+decltype(auto) Fundamental<T>::visitInPlace(Lambda& lambda)
+{
+    if constexpr (kConcurrentReads)
+    {
+        // readers may load() at any time: modify a copy and publish it with a single store
+        T copy(underlying);
+
+        auto const publishIfChanged = [this, &copy]
         {
-            ++Value::recursiveListenerDisabler;
-            auto raiiDecrementer = cxxutils::callAtEndOfScope(std::false_type(),
-                                                              [] (std::false_type)
-                                                              {
-                                                                  --Value::recursiveListenerDisabler;
-                                                              });
-            underlying = std::move(copy);
+            if (isEqual(copy, underlying))
+                return;
+
+            store(copy);
+            notifyChanged();
+        };
+
+        if constexpr (std::is_void_v<std::invoke_result_t<Lambda&, T&>>)
+        {
+            lambda(copy);
+            publishIfChanged();
+            return;
         }
+        else
+        {
+            // returned by value as references into copy would dangle
+            auto result = lambda(copy);
+            publishIfChanged();
+            return result;
+        }
+    }
+    else
+    {
+        // only needed to detect no-op visits: for arithmetic types this is a register copy
+        T const previous(underlying);
+
+        auto const notifyIfChanged = [this, &previous]
+        {
+            if (isEqual(previous, underlying))
+                return;
 
-        if (Value::recursiveListenerDisabler == 0)
-            callListeners();
+            notifyChanged();
+        };
+
+        if constexpr (std::is_void_v<std::invoke_result_t<Lambda&, T&>>)
+        {
+            lambda(underlying);
+            notifyIfChanged();
+        }
+        else
+        {
+            decltype(auto) result = lambda(underlying);
+            notifyIfChanged();
+            return result;
+        }
+    }
+}
+
+template <typename T>
+T Fundamental<T>::load() const requires kConcurrentReads
+{
+    if constexpr (! kUsesSequenceLock)
+    {
+        return std::atomic_ref<T>(const_cast<T&>(underlying)).load(std::memory_order_acquire);
+    }
+    else
+    {
+        // the bytes are copied non-atomically and discarded if a store overlapped the copy
+        for (;;)
+        {
+            auto const before = sequence.load(std::memory_order_acquire);
+
+            if ((before & 1u) == 0)
+            {
+                std::array<std::byte, sizeof(T)> bytes;
+                std::memcpy(bytes.data(), &underlying, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (sequence.load(std::memory_order_relaxed) == before)
+                    return std::bit_cast<T>(bytes);
+            }
+        }
+    }
+}
+
+template <typename T>
+template <typename FieldType>
+void Fundamental<T>::notifyChanged()
+{
+    auto const hooked = this->markChanged();
+
+    // a record assigned as a whole runs the hooks and notifies once it is stored (see store())
+    if (this->isInAssignedRecord())
+        return;
+
+    static constexpr auto kStaticHooks = std::invoke([]
+    {
+        if constexpr (std::is_void_v<FieldType>)
+            return false;
+        else
+            return FieldType::kHasHooks;
+    });
+
+    if constexpr (kStaticHooks)
+    {
+        // fields outside of a record do not run hooks
+        if (auto* record = this->parent; record != nullptr)
+            FieldType::HooksPolicy::changed(static_cast<FieldType&>(*this), record);
+    }
+
+    this->runFieldHooks(hooked, kStaticHooks);
+    callListeners();
+}
+
+template <typename T>
+template <typename FieldType, typename U>
+void Fundamental<T>::setField(U && newValue)
+{
+    if (isEqual(underlying, newValue))
+        return;
+
+    store(std::forward<U>(newValue));
+    notifyChanged<FieldType>();
+}
+
+template <typename T>
+template <typename U>
+void Fundamental<T>::store(U&& newValue)
+{
+    if constexpr (! kIsOpaque)
+    {
+        // assigning T assigns each of its fields, which must not notify on their own:
+        // notifyChanged() reports the whole assignment as a single change of this record
+        auto const* previous = std::exchange(Value::assignedRecord, this);
+        auto const restore = cxxutils::callAtEndOfScope(previous, [] (Value const* p) { Value::assignedRecord = p; });
+
+        underlying = std::forward<U>(newValue);
+
+        // the hooks see the record with all its fields stored, and their writes are part of the assignment
+        if (auto const* hooks = this->fieldHooks; hooks != nullptr)
+            hooks->assigned(*this);
+    }
+    else if constexpr (! kConcurrentReads)
+    {
+        underlying = std::forward<U>(newValue);
+    }
+    else if constexpr (! kUsesSequenceLock)
+    {
+        std::atomic_ref<T>(underlying).store(newValue, std::memory_order_release);
+    }
+    else
+    {
+        auto const before = sequence.load(std::memory_order_relaxed);
+        sequence.store(before + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        underlying = newValue;
+        sequence.store(before + 2, std::memory_order_release);
     }
 }
 
@@ -336,11 +739,7 @@ template <typename T>
 template <std::invocable<Fundamental<T> const&> Lambda>
 ListenerToken Fundamental<T>::addListener(Lambda && lambda) const
 {
-    ListenerToken token(ListenerToken::private_constructor_t{});
-
-    // Add the listener to the vector
-    valueListeners.emplace(std::weak_ptr<ListenerToken::Impl>(token.token), std::move(lambda));
-    return token;
+    return valueListeners.add(std::move(lambda));
 }
 
 template <typename T>
@@ -354,13 +753,6 @@ template <typename T>
 template <class Context, std::invocable<Fundamental<T> const&> Lambda>
 void Fundamental<T>::addListener(std::weak_ptr<Context>&& context, Lambda && lambda) const
 {
-    // Clean up expired managed listeners first
-    managedValueListeners.erase(
-        std::remove_if(managedValueListeners.begin(), managedValueListeners.end(),
-            [](auto const& ml) { return ml.context.expired(); }),
-        managedValueListeners.end()
-    );
-
     // Capture the weak_ptr and wrap the lambda
     auto wrappedLambda = [weakCtx = context, userLambda = std::move(lambda)]
                         (Fundamental<T> const& fund)
@@ -369,9 +761,8 @@ void Fundamental<T>::addListener(std::weak_ptr<Context>&& context, Lambda && lam
             userLambda(fund);
     };
 
-    // Add the token-based listener and store the token
-    auto token = addListener(std::move(wrappedLambda));
-    managedValueListeners.push_back({std::weak_ptr<void>(context), std::move(token)});
+    // The list keeps the listener until the context expires
+    valueListeners.add(std::weak_ptr<void>(context), std::move(wrappedLambda));
 }
 
 #if JUCE_SUPPORT
@@ -379,13 +770,6 @@ template <typename T>
 template <class ComponentType, std::invocable<Fundamental<T> const&> Lambda>
 void Fundamental<T>::addListener(ComponentType* context, Lambda && lambda) const requires std::is_base_of_v<juce::Component, ComponentType>
 {
-    // Clean up expired managed listeners first
-    managedValueListeners.erase(
-        std::remove_if(managedValueListeners.begin(), managedValueListeners.end(),
-            [](auto const& ml) { return ml.context.expired(); }),
-        managedValueListeners.end()
-    );
-
     // Create a SafePointer and wrap the lambda
     juce::Component::SafePointer<ComponentType> safeContext(context);
     auto wrappedLambda = [safeContext, userLambda = std::move(lambda)]
@@ -395,9 +779,8 @@ void Fundamental<T>::addListener(ComponentType* context, Lambda && lambda) const
             userLambda(fund);
     };
 
-    // Add the token-based listener and store the token
-    auto token = addListener(std::move(wrappedLambda));
-    managedValueListeners.push_back({std::weak_ptr<void>(), std::move(token)});
+    // JUCE components have no weak_ptr: the SafePointer tells when to drop the listener
+    valueListeners.addWhile([safeContext] { return safeContext.getComponent() != nullptr; }, std::move(wrappedLambda));
 }
 #endif
 
@@ -412,6 +795,27 @@ bool Fundamental<T>::assign(Value const& other)
     return true;
 }
 
+template <typename T>
+std::uint64_t Fundamental<T>::contentHash() const
+{
+    if constexpr (kIsOpaque)
+    {
+        return detail::leaf_content_hash(underlying);
+    }
+    else
+    {
+        return Base::cachedContentHash([this]
+        {
+            return std::apply([] (auto const&... fields)
+            {
+                auto hash = detail::SchemaHash<T>::value;
+                ((hash = detail::fnv1a(fields.contentHash(), hash)), ...);
+                return hash;
+            }, detail::filter_tuple<detail::is_field>(boost::pfr::structure_tie(underlying)));
+        });
+    }
+}
+
 #if JUCE_SUPPORT
 template <typename T>
 juce::Value Fundamental<T>::getUnderlyingValue() requires Fundamental<T>::kIsOpaque
@@ -433,8 +837,10 @@ juce::var Fundamental<T>::DynamicValueSource::getValue() const
     if constexpr (kIsOpaque)
     {
         if constexpr (std::is_same_v<T, std::int8_t> || std::is_same_v<T, std::int16_t> || std::is_same_v<T, std::int32_t>) return juce::var(static_cast<int>(parent->underlying));
-        if constexpr (std::is_same_v<T, std::int64_t>) return juce::var(static_cast<juce::int64>(parent->underlying));
-        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) return juce::var(static_cast<double>(parent->underlying));
+        if constexpr (std::is_same_v<T, std::uint8_t> || std::is_same_v<T, std::uint16_t>) return juce::var(static_cast<int>(parent->underlying));
+        // juce::var has no unsigned 32/64-bit type: uint32_t fits into int64, uint64_t is stored bit-wise
+        if constexpr (std::is_same_v<T, std::int64_t> || std::is_same_v<T, std::uint32_t> || std::is_same_v<T, std::uint64_t>) return juce::var(static_cast<juce::int64>(parent->underlying));
+        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, long double>) return juce::var(static_cast<double>(parent->underlying));
         if constexpr (std::is_same_v<T, bool>) return juce::var(parent->underlying);
         if constexpr (std::is_same_v<T, std::string>) return juce::var(juce::String(parent->underlying));
         if constexpr (std::is_same_v<T, ID>) return juce::var(juce::String(parent->underlying.toString()));
@@ -449,8 +855,9 @@ void Fundamental<T>::DynamicValueSource::setValue(juce::var const& newVar)
     if constexpr (kIsOpaque)
     {
         if constexpr (std::is_same_v<T, std::int8_t> || std::is_same_v<T, std::int16_t> || std::is_same_v<T, std::int32_t>) parent->set(static_cast<T>(static_cast<int>(newVar)));
-        else if constexpr (std::is_same_v<T, std::int64_t>) parent->set(static_cast<std::int64_t>(static_cast<juce::int64>(newVar)));
-        else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) parent->set(static_cast<T>(static_cast<double>(newVar)));
+        else if constexpr (std::is_same_v<T, std::uint8_t> || std::is_same_v<T, std::uint16_t>) parent->set(static_cast<T>(static_cast<int>(newVar)));
+        else if constexpr (std::is_same_v<T, std::int64_t> || std::is_same_v<T, std::uint32_t> || std::is_same_v<T, std::uint64_t>) parent->set(static_cast<T>(static_cast<juce::int64>(newVar)));
+        else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, long double>) parent->set(static_cast<T>(static_cast<double>(newVar)));
         else if constexpr (std::is_same_v<T, bool>) parent->set(static_cast<bool>(newVar));
         else if constexpr (std::is_same_v<T, std::string>) parent->set(static_cast<juce::String>(newVar).toStdString());
         else if constexpr (std::is_same_v<T, ID>) parent->set(ID::fromString(static_cast<juce::String>(newVar).toStdString()));
@@ -461,20 +868,12 @@ void Fundamental<T>::DynamicValueSource::setValue(juce::var const& newVar)
 template <typename T>
 void Fundamental<T>::callListeners()
 {
-    std::erase_if(valueListeners, [] (auto const& p) { return p.first.expired(); });
-
-    for (auto& [token, listener] : valueListeners)
-    {
-        // we need to check if the token expired again, becaus other listeners may have caused it to be expired
-        if (token.expired())
-            continue;
-
-        listener(*this);
-    }
+    valueListeners.call(*this);
 
     if (Base::parent != nullptr)
     {
-        Base::parent->callChildListeners(std::vector<std::string>(1, std::string(this->fieldname())), Object::Operation::modify, *Base::parent, *this);
+        if (auto const kinds = Base::parent->propagateChildChange())
+            Base::parent->notifyChildChange(kinds, this->fieldname(), Object::Operation::modify, *this);
     }
 
 #if JUCE_SUPPORT
@@ -486,22 +885,6 @@ void Fundamental<T>::callListeners()
 #endif
 }
 
-template <typename T>
-typename Value::TypesVariant Fundamental<T>::visit_helper()
-{
-    if constexpr (kIsOpaque)
-        return {std::reference_wrapper<T>(underlying)};
-    return Base::visit_helper();
-}
-
-template <typename T>
-typename Value::ConstTypesVariant Fundamental<T>::visit_helper() const
-{
-    if constexpr (kIsOpaque)
-        return {std::reference_wrapper<T const>(underlying)};
-    return Base::visit_helper();
-}
-
 //=============================================================================
 // operator""_fld implementation
 //=============================================================================
@@ -545,6 +928,22 @@ Record<T>::Record(T const& underlying_) : Fundamental<T>(underlying_)
     init();
 }
 
+template <typename T>
+Record<T>::Record(std::pmr::memory_resource* resource) : Record(MemoryResourceScope(resource))
+{}
+
+template <typename T>
+Record<T>::Record(T const& underlying_, std::pmr::memory_resource* resource) : Record(underlying_, MemoryResourceScope(resource))
+{}
+
+template <typename T>
+Record<T>::Record(MemoryResourceScope const&) : Record()
+{}
+
+template <typename T>
+Record<T>::Record(T const& underlying_, MemoryResourceScope const&) : Record(underlying_)
+{}
+
 template <typename T>
 Record<T>::Record(Record const& o) : Fundamental<T>(o.underlying)
 {
@@ -578,12 +977,15 @@ auto&& Record<T>::operator()(this auto& self, CompileTimeString<FieldName>)
     return std::apply([] <typename... Types> (Types &&... fields) -> auto&&
     {
         return detail::FindFieldHelper<FieldName>::eval(std::forward<Types>(fields)...);
-    }, self.fields());
+    }, fields_with(self.underlying));
 }
 
 template <typename T>
 auto Record<T>::fields(this auto& self)
 {
+    if constexpr (kHasComputedFields)
+        Record::refresh(self);
+
     return fields_with(self.underlying);
 }
 
@@ -599,6 +1001,27 @@ std::vector<std::reference_wrapper<Value>> Record<T>::typeErasedFields()
     return typeErasedFields_internal();
 }
 
+template <typename T>
+Value const& Record<T>::fieldAt(std::size_t idx) const
+{
+    // jump table with one accessor per field
+    static constexpr auto kAccessors = std::invoke([] <std::size_t... Is> (std::index_sequence<Is...>)
+    {
+        return std::array<Value const& (*)(Record const&), sizeof...(Is)>
+        {
+            +[] (Record const& self) -> Value const& { return std::get<Is>(self.fields()); }...
+        };
+    }, std::make_index_sequence<kFieldNames.size()>());
+
+    return idx < kAccessors.size() ? kAccessors[idx](*this) : Value::kInvalid;
+}
+
+template <typename T>
+Value& Record<T>::fieldAt(std::size_t idx)
+{
+    return const_cast<Value&>(std::as_const(*this).fieldAt(idx));
+}
+
 template <typename T>
 template <typename Lambda>
 void Record<T>::visitFields(this auto& self, Lambda && lambda) noexcept
@@ -665,7 +1088,162 @@ void Record<T>::init()
     std::apply([this] (auto &&... flds)
     {
         (std::invoke([this, &flds] { flds.parent = this; }), ...);
-    }, fields());
+    }, fields_with(this->underlying));
+
+    if constexpr (kHasFieldHooks)
+    {
+        this->fieldHooks = &kFieldHooks;
+
+        // computed on first read
+        std::apply([] <typename... Fields> (Fields&... flds)
+        {
+            ([&flds]
+            {
+                if constexpr (Fields::kIsComputed)
+                    flds.dirty = true;
+            }(), ...);
+        }, fields_with(this->underlying));
+    }
+}
+
+template <typename T>
+void Record<T>::fieldChanged(Object& record, Value& field, bool ownHooksRan)
+{
+    auto& self = static_cast<Record&>(record);
+    auto const flds = fields_with(self.underlying);
+
+    if constexpr (kHasComputedFields)
+    {
+        // a value written to a computed field holds until a dependency changes
+        std::apply([&field] <typename... Fields> (Fields&... fs)
+        {
+            ([&field, &fs]
+            {
+                if constexpr (Fields::kIsComputed)
+                    if (&field == &static_cast<Value&>(fs))
+                        fs.dirty = false;
+            }(), ...);
+        }, flds);
+
+        invalidate(self, field);
+    }
+
+    // only fields with hooks are compared with the changed field
+    std::invoke([&] <std::size_t... Is> (std::index_sequence<Is...>)
+    {
+        ([&]
+        {
+            if constexpr (std::tuple_element_t<Is, FieldsAsTuple>::kHasHooks)
+                if (! ownHooksRan && &field == &static_cast<Value&>(std::get<Is>(flds)))
+                    runHooks(std::get<Is>(flds), record);
+        }(), ...);
+    }, std::make_index_sequence<std::tuple_size_v<FieldsAsTuple>>());
+}
+
+template <typename T>
+void Record<T>::recordAssigned(Object& record)
+{
+    auto& self = static_cast<Record&>(record);
+
+    std::apply([&record] <typename... Fields> (Fields&... flds)
+    {
+        ([&flds]
+        {
+            if constexpr (Fields::kIsComputed)
+                flds.dirty = true;
+        }(), ...);
+
+        ([&record, &flds]
+        {
+            if constexpr (Fields::kHasHooks)
+                runHooks(flds, record);
+        }(), ...);
+    }, fields_with(self.underlying));
+}
+
+template <typename T>
+void Record<T>::refresh(Object const& record)
+{
+    // computing is part of reading: the record is only logically const
+    auto& self = const_cast<Record&>(static_cast<Record const&>(record));
+
+    std::apply([&self] <typename... Fields> (Fields&... flds)
+    {
+        ([&self, &flds]
+        {
+            if constexpr (Fields::kIsComputed)
+            {
+                // cleared first: computing a field which depends on a computed field refreshes again
+                if (flds.dirty)
+                {
+                    flds.dirty = false;
+                    flds.storeComputed(self.template computeValue<Fields>());
+                }
+            }
+        }(), ...);
+    }, fields_with(self.underlying));
+}
+
+template <typename T>
+void Record<T>::invalidate(Record& self, Value const& changed)
+{
+    auto const flds = fields_with(self.underlying);
+
+    std::invoke([&] <std::size_t... Is> (std::index_sequence<Is...>)
+    {
+        ([&]
+        {
+            using FieldType = std::tuple_element_t<Is, FieldsAsTuple>;
+
+            if constexpr (FieldType::kIsComputed)
+            {
+                static constexpr auto kIndices = dependencyIndices<FieldType>();
+
+                auto const isDependency = std::invoke([&] <std::size_t... Js> (std::index_sequence<Js...>)
+                {
+                    return ((&changed == &static_cast<Value const&>(std::get<kIndices[Js]>(flds))) || ...);
+                }, std::make_index_sequence<kIndices.size()>());
+
+                if (isDependency)
+                {
+                    auto& computed = std::get<Is>(flds);
+
+                    // changedSince() reports the field with the write of its dependency
+                    computed.dirty = true;
+                    computed.lastChangedVersion = self.subtreeVersion();
+                    invalidate(self, computed);
+                }
+            }
+        }(), ...);
+    }, std::make_index_sequence<std::tuple_size_v<FieldsAsTuple>>());
+}
+
+template <typename T>
+template <typename FieldType>
+void Record<T>::runHooks(FieldType& field, Object& record)
+{
+    using Hooks = typename FieldType::HooksPolicy;
+
+    static_assert(requires (FieldType& f, Object* parent) { Hooks::changed(f, parent); },
+                  "A hooks policy needs a static member function changed(field, parent), see NoFieldHooks");
+
+    Hooks::changed(field, &record);
+}
+
+template <typename T>
+template <typename ComputedType>
+auto Record<T>::computeValue()
+{
+    static constexpr auto kIndices = dependencyIndices<ComputedType>();
+    static_assert(std::ranges::all_of(kIndices, [] (std::size_t idx) { return idx < kFieldNames.size(); }),
+                  "A computed field depends on a field which does not exist");
+
+    auto const flds = fields_with(this->underlying);
+
+    return std::invoke([&flds] <std::size_t... Js> (std::index_sequence<Js...>)
+    {
+        return ComputedType::compute(std::get<kIndices[Js]>(flds)...);
+    }, std::make_index_sequence<kIndices.size()>());
 }
 
 // overridden base methods
@@ -687,47 +1265,158 @@ bool Record<T>::removeChild(std::string const&)
     return false;
 }
 
+template <typename T>
+bool operator==(Record<T> const& a, Record<T> const& b)
+{
+    return detail::values_equal<T, Record<T>>(a, b);
+}
+
 //=============================================================================
 // Array implementations
 //=============================================================================
 
 template <typename T>
-Array<T>::Array(Array const& o) : Object(o), elements()
+Array<T>::Array(Array const& o) : Object(o), elements(MemoryResourceScope::current())
 {
+    // an unmodified lazy array is copied by sharing its source
+    if (o.lazySource != nullptr && ! o.lazyModified)
+    {
+        lazySource = o.lazySource;
+        lazyPending = true;
+        return;
+    }
+
+    elements.reserve(o.elements.size());
+
     // Copy elements but not arrayListeners
     for (auto const& elem : o.elements)
         elements.emplace_back(*this, elem());
 }
 
 template <typename T>
-std::vector<std::reference_wrapper<Value const>> Array<T>::typeErasedFields() const
+Array<T>::Array(Array&& o)
+    : Object(std::move(o)),
+      elements(std::move(o.elements)),
+      lazySource(std::move(o.lazySource)),
+      lazyPending(o.lazyPending),
+      lazyModified(o.lazyModified),
+      arrayListeners(std::move(o.arrayListeners))
+{
+    o.lazyPending = false;
+
+    for (auto& element : elements)
+        static_cast<Value&>(element).parent = this;
+}
+
+template <typename T>
+void Array<T>::setLazySource(std::shared_ptr<LazyElementSource<T> const> source)
+{
+    // elements of a previous source which were never loaded are dropped without loading them
+    if (! lazyPending)
+        while (! elements.empty())
+            removeElement(elements.size() - 1);
+
+    lazySource = std::move(source);
+    lazyPending = (lazySource != nullptr);
+    lazyModified = false;
+    markChanged();
+}
+
+template <typename T>
+void Array<T>::load() const
+{
+    if (! lazyPending)
+        return;
+
+    lazyPending = false;
+
+    // elements is mutable, the elements only need a non-const parent pointer
+    auto& self = const_cast<Array&>(*this);
+    MemoryResourceScope scope(resource());
+
+    auto const n = lazySource->size();
+    elements.reserve(n);
+
+    for (std::size_t idx = 0; idx < n; ++idx)
+        elements.emplace_back(self, lazySource->element(idx));
+}
+
+template <typename T>
+std::size_t Array<T>::compact()
+{
+    if (lazyPending)
+        return 0;
+
+    if (lazySource != nullptr && ! lazyModified)
+    {
+        ElementVector(elements.get_allocator()).swap(elements);
+        lazyPending = true;
+        return 1;
+    }
+
+    return Object::compact();
+}
+
+template <typename T>
+std::vector<std::reference_wrapper<Value const>> Array<T>::typeErasedFields() const
+{
+    return typeErasedFields_internal();
+}
+
+template <typename T>
+std::vector<std::reference_wrapper<Value>> Array<T>::typeErasedFields()
+{
+    return typeErasedFields_internal();
+}
+
+template <typename T>
+Value const& Array<T>::fieldAt(std::size_t idx) const
 {
-    return typeErasedFields_internal();
+    auto const& elems = loadedElements();
+
+    if (idx >= elems.size())
+        return Value::kInvalid;
+
+    return elems[idx];
 }
 
 template <typename T>
-std::vector<std::reference_wrapper<Value>> Array<T>::typeErasedFields()
+Value& Array<T>::fieldAt(std::size_t idx)
 {
-    return typeErasedFields_internal();
+    return const_cast<Value&>(std::as_const(*this).fieldAt(idx));
 }
 
 template <typename T>
 void Array<T>::addElement(T const& element)
 {
-    elements.emplace_back(*this, element);
+    load();
+
+    {
+        // nested containers of the new element allocate from this container's resource
+        MemoryResourceScope scope(resource());
+        elements.emplace_back(*this, element);
+    }
+
     callListeners(Operation::add, elements.back()(), elements.size() - 1);
 }
 
 template <typename T>
 void Array<T>::addElement(T&& element)
 {
-    elements.emplace_back(*this, std::move(element));
+    load();
+
+    {
+        MemoryResourceScope scope(resource());
+        elements.emplace_back(*this, std::move(element));
+    }
+
     callListeners(Operation::add, elements.back()(), elements.size() - 1);
 }
 
 template <typename T>
 void Array<T>::removeElement(std::size_t idx)
 {
+    load();
     assert(idx < elements.size());
     T removedValue = elements[idx]();
     elements.erase(elements.begin() + static_cast<int>(idx));
@@ -738,11 +1427,7 @@ template <typename T>
 template <std::invocable<Object::Operation, Array<T> const&, T const&, std::size_t> Lambda>
 ListenerToken Array<T>::addListener(Lambda && lambda)
 {
-    ListenerToken token(ListenerToken::private_constructor_t{});
-
-    // Add the listener to the vector
-    arrayListeners.emplace(std::weak_ptr<ListenerToken::Impl>(token.token), std::move(lambda));
-    return token;
+    return arrayListeners.add(std::move(lambda));
 }
 
 template <typename T>
@@ -756,13 +1441,6 @@ template <typename T>
 template <class Context, std::invocable<Object::Operation, Array<T> const&, T const&, std::size_t> Lambda>
 void Array<T>::addListener(std::weak_ptr<Context> && context, Lambda && lambda)
 {
-    // Clean up expired managed listeners first
-    managedArrayListeners.erase(
-        std::remove_if(managedArrayListeners.begin(), managedArrayListeners.end(),
-            [](auto const& ml) { return ml.context.expired(); }),
-        managedArrayListeners.end()
-    );
-
     // Capture the weak_ptr and wrap the lambda
     auto wrappedLambda = [weakCtx = context, userLambda = std::move(lambda)]
                         (Operation op, Array<T> const& arr, T const& elem, std::size_t idx)
@@ -771,9 +1449,8 @@ void Array<T>::addListener(std::weak_ptr<Context> && context, Lambda && lambda)
             userLambda(op, arr, elem, idx);
     };
 
-    // Add the token-based listener and store the token
-    auto token = addListener(std::move(wrappedLambda));
-    managedArrayListeners.push_back({std::weak_ptr<void>(context), std::move(token)});
+    // The list keeps the listener until the context expires
+    arrayListeners.add(std::weak_ptr<void>(context), std::move(wrappedLambda));
 }
 
 #if JUCE_SUPPORT
@@ -781,13 +1458,6 @@ template <typename T>
 template <class ComponentType, std::invocable<Object::Operation, Array<T> const&, T const&, std::size_t> Lambda>
 void Array<T>::addListener(ComponentType* context, Lambda && lambda) requires std::is_base_of_v<juce::Component, ComponentType>
 {
-    // Clean up expired managed listeners first
-    managedArrayListeners.erase(
-        std::remove_if(managedArrayListeners.begin(), managedArrayListeners.end(),
-            [](auto const& ml) { return ml.context.expired(); }),
-        managedArrayListeners.end()
-    );
-
     // Create a SafePointer and wrap the lambda
     juce::Component::SafePointer<ComponentType> safeContext(context);
     auto wrappedLambda = [safeContext, userLambda = std::move(lambda)]
@@ -797,9 +1467,8 @@ void Array<T>::addListener(ComponentType* context, Lambda && lambda) requires st
             userLambda(op, arr, elem, idx);
     };
 
-    // Add the token-based listener and store the token
-    auto token = addListener(std::move(wrappedLambda));
-    managedArrayListeners.push_back({std::weak_ptr<void>(), std::move(token)});
+    // JUCE components have no weak_ptr: the SafePointer tells when to drop the listener
+    arrayListeners.addWhile([safeContext] { return safeContext.getComponent() != nullptr; }, std::move(wrappedLambda));
 }
 #endif
 
@@ -811,7 +1480,7 @@ auto Array<T>::typeErasedFields_internal(this auto && self)
     using ReturnType = std::vector<std::reference_wrapper<ElementType>>;
 
     ReturnType returnValue;
-    for (auto& element : self.elements)
+    for (auto& element : self.loadedElements())
         returnValue.emplace_back(element);
 
     return returnValue;
@@ -827,6 +1496,9 @@ template <typename T>
 Array<T>::Element::Element(Element const& o) : Base(o)
 {
     init(static_cast<Array<T>&>(*o.parent));
+
+    // elements are only copied when the container relocates them
+    this->copyVersionsFrom(o);
 }
 
 template <typename T>
@@ -876,22 +1548,21 @@ void Array<T>::Element::init(Array& container_)
 }
 
 template <typename T>
-void Array<T>::callListeners(Operation op, T const& newValue, std::size_t idx) const
+void Array<T>::callListeners(Operation op, T const& newValue, std::size_t idx)
 {
-    std::erase_if(arrayListeners, [] (auto const& p) { return p.first.expired(); });
+    // elements are always added at the back
+    if (op == Operation::add)
+        elements.back().markChanged();
 
-    for (auto& [token, listener] : arrayListeners)
-    {
-        // we need to check if the token expired again, becaus other listeners may have caused it to be expired
-        if (token.expired())
-            continue;
+    if (auto const hooked = markChanged(); ! isInAssignedRecord())
+        runFieldHooks(hooked);
 
-        listener(op, *this, newValue, idx);
-    }
+    arrayListeners.call(op, *this, newValue, idx);
 
+    if (auto const kinds = propagateChildChange())
     {
         std::conditional_t<Fundamental<T>::kIsOpaque, Fundamental<T>, Record<T>> newValueTypeErased(newValue);
-        callChildListeners(std::vector<std::string>(1, std::to_string(idx)), op, *this, newValueTypeErased);
+        notifyChildChange(kinds, std::to_string(idx), op, newValueTypeErased);
     }
 }
 
@@ -904,15 +1575,32 @@ bool Array<T>::assign(Value const& unsafeOther)
     
     auto const& other = static_cast<Array const&>(unsafeOther);
 
+    load();
+
     while (elements.size())
         removeElement(elements.size() - 1);
 
-    for (auto const& otherElement : other.elements)
+    for (auto const& otherElement : other.loadedElements())
         addElement(static_cast<T>(otherElement));
 
     return true;
 }
 
+template <typename T>
+std::uint64_t Array<T>::contentHash() const
+{
+    return cachedContentHash([this]
+    {
+        auto const& elems = loadedElements();
+        auto hash = detail::fnv1a(elems.size(), detail::SchemaHash<Array>::value);
+
+        for (auto const& element : elems)
+            hash = detail::fnv1a(element.contentHash(), hash);
+
+        return hash;
+    });
+}
+
 template <typename T>
 bool Array<T>::assignChild(std::string const& name, Value const& newValue)
 {
@@ -932,6 +1620,8 @@ bool Array<T>::assignChild(std::string const& name, Value const& newValue)
     if (index < 0)
         return false;
 
+    load();
+
     if (static_cast<std::size_t>(index) < elements.size())
         return elements[static_cast<std::size_t>(index)].assign(newValue);
 
@@ -955,18 +1645,25 @@ bool Array<T>::removeChild(std::string const& name)
         return false;
     }
 
-    if (index < 0 || static_cast<std::size_t>(index) >= elements.size())
+    if (index < 0 || static_cast<std::size_t>(index) >= size())
         return false;
-    
+
     removeElement(static_cast<std::size_t>(index));
     return true;
 }
 template <typename T>
 bool operator==(Array<T> const& aarray, Array<T> const& barray)
 {
-    auto const n = aarray.elements.size();
+    if (aarray.lazyPending && barray.lazyPending && aarray.lazySource == barray.lazySource)
+        return true;
+
+    // O(1) if both hashes were computed before: different hashes prove inequality, equal hashes prove nothing
+    if (auto const ahash = aarray.cachedContentHash(), bhash = barray.cachedContentHash(); ahash && bhash && *ahash != *bhash)
+        return false;
 
-    if (n != barray.elements.size())
+    auto const n = aarray.loadedElements().size();
+
+    if (n != barray.loadedElements().size())
         return false;
 
     for (std::size_t i = 0; i < n; ++i)
@@ -974,7 +1671,7 @@ bool operator==(Array<T> const& aarray, Array<T> const& barray)
         auto const& a = aarray.elements[i];
         auto const& b = barray.elements[i];
 
-        if (a != b)
+        if (! detail::values_equal<T>(a, b))
             return false;
     }
 
@@ -991,11 +1688,85 @@ namespace dynamic
 //=============================================================================
 
 template <typename T>
-Map<T>::Map(Map const& o) : Object(o), elements()
+Map<T>::Map(Map const& o) : Object(o), elements(MemoryResourceScope::current())
 {
+    // an unmodified lazy map is copied by sharing its source
+    if (o.lazySource != nullptr && ! o.lazyModified)
+    {
+        lazySource = o.lazySource;
+        lazyPending = true;
+        return;
+    }
+
+    elements.reserve(o.elements.size());
+
     // Copy elements but not mapListeners
     for (auto const& elem : o.elements)
-        elements.emplace_back(elem.fieldName, *this, elem());
+        elements.emplace_back(elem.key, *this, elem());
+}
+
+template <typename T>
+Map<T>::Map(Map&& o)
+    : Object(std::move(o)),
+      elements(std::move(o.elements)),
+      lazySource(std::move(o.lazySource)),
+      lazyPending(o.lazyPending),
+      lazyModified(o.lazyModified),
+      mapListeners(std::move(o.mapListeners))
+{
+    o.lazyPending = false;
+
+    for (auto& element : elements)
+        static_cast<Value&>(element).parent = this;
+}
+
+template <typename T>
+void Map<T>::setLazySource(std::shared_ptr<LazyElementSource<T> const> source)
+{
+    // elements of a previous source which were never loaded are dropped without loading them
+    if (! lazyPending)
+        while (! elements.empty())
+            removeElementAt(std::prev(elements.end()));
+
+    lazySource = std::move(source);
+    lazyPending = (lazySource != nullptr);
+    lazyModified = false;
+    markChanged();
+}
+
+template <typename T>
+void Map<T>::load() const
+{
+    if (! lazyPending)
+        return;
+
+    lazyPending = false;
+
+    // elements is mutable, the elements only need a non-const parent pointer
+    auto& self = const_cast<Map&>(*this);
+    MemoryResourceScope scope(resource());
+
+    auto const n = lazySource->size();
+    elements.reserve(n);
+
+    for (std::size_t idx = 0; idx < n; ++idx)
+        elements.emplace_back(MapKey(lazySource->key(idx)), self, lazySource->element(idx));
+}
+
+template <typename T>
+std::size_t Map<T>::compact()
+{
+    if (lazyPending)
+        return 0;
+
+    if (lazySource != nullptr && ! lazyModified)
+    {
+        ElementVector(elements.get_allocator()).swap(elements);
+        lazyPending = true;
+        return 1;
+    }
+
+    return Object::compact();
 }
 
 template <typename T>
@@ -1010,55 +1781,155 @@ std::vector<std::reference_wrapper<Value>> Map<T>::typeErasedFields()
     return typeErasedFields_internal();
 }
 
+template <typename T>
+Value const& Map<T>::fieldAt(std::size_t idx) const
+{
+    auto const& elems = loadedElements();
+
+    if (idx >= elems.size())
+        return Value::kInvalid;
+
+    return elems[idx];
+}
+
+template <typename T>
+Value& Map<T>::fieldAt(std::size_t idx)
+{
+    return const_cast<Value&>(std::as_const(*this).fieldAt(idx));
+}
+
 template <typename T>
 void Map<T>::addElement(std::string_view key, T const& element)
 {
-    if (auto it = std::find_if(elements.begin(), elements.end(), [key] (Element const& elem) { return elem.fieldName == key; }); it != elements.end())
+    if (auto it = findElement(key); it != elements.end())
     {
         *it = element;
         return;
     }
 
-    elements.emplace_back(key, *this, element);
-    callListeners(Operation::add, elements.back()(), key);
+    {
+        // nested containers of the new element allocate from this container's resource
+        MemoryResourceScope scope(resource());
+        elements.emplace_back(MapKey(key), *this, element);
+    }
+
+    callListeners(Operation::add, elements.back()(), elements.back().key);
 }
 
 template <typename T>
 void Map<T>::addElement(std::string_view key, T&& element)
 {
-    if (auto it = std::find_if(elements.begin(), elements.end(), [key] (Element const& elem) { return elem.fieldName == key; }); it != elements.end())
+    if (auto it = findElement(key); it != elements.end())
+    {
+        *it = std::move(element);
+        return;
+    }
+
+    {
+        MemoryResourceScope scope(resource());
+        elements.emplace_back(MapKey(key), *this, std::move(element));
+    }
+
+    callListeners(Operation::add, elements.back()(), elements.back().key);
+}
+
+template <typename T>
+void Map<T>::addElement(MapKey key, T const& element)
+{
+    if (auto it = findElement(key); it != elements.end())
+    {
+        *it = element;
+        return;
+    }
+
+    {
+        MemoryResourceScope scope(resource());
+        elements.emplace_back(std::move(key), *this, element);
+    }
+
+    callListeners(Operation::add, elements.back()(), elements.back().key);
+}
+
+template <typename T>
+void Map<T>::addElement(MapKey key, T&& element)
+{
+    if (auto it = findElement(key); it != elements.end())
     {
         *it = std::move(element);
         return;
     }
 
-    elements.emplace_back(key, *this, std::move(element));
-    callListeners(Operation::add, elements.back()(), key);
+    {
+        MemoryResourceScope scope(resource());
+        elements.emplace_back(std::move(key), *this, std::move(element));
+    }
+
+    callListeners(Operation::add, elements.back()(), elements.back().key);
 }
 
 template <typename T>
 bool Map<T>::removeElement(std::string_view key)
 {
-    auto it = std::find_if(elements.begin(), elements.end(), [key] (Element const& elem) { return elem.fieldName == key; });
+    auto it = findElement(key);
 
     if (it == elements.end())
         return false;
 
-    T removedValue = (*it)();
-    elements.erase(it);
-    callListeners(Operation::remove, removedValue, key);
+    removeElementAt(it);
+    return true;
+}
+
+template <typename T>
+bool Map<T>::removeElement(MapKey const& key)
+{
+    auto it = findElement(key);
+
+    if (it == elements.end())
+        return false;
+
+    removeElementAt(it);
     return true;
 }
 
+template <typename T>
+void Map<T>::removeElementAt(auto it)
+{
+    // take the key out of the element: the caller's key may refer to it
+    T removedValue = (*it)();
+    MapKey removedKey = std::move(it->key);
+
+    {
+        // the following elements move up with their keys: their paths and values do not change
+        auto const* previous = std::exchange(Value::assignedRecord, this);
+        auto const restore = cxxutils::callAtEndOfScope(previous, [] (Value const* p) { Value::assignedRecord = p; });
+        elements.erase(it);
+    }
+
+    callListeners(Operation::remove, removedValue, removedKey);
+}
+
+template <typename T>
+auto Map<T>::findElement(this auto && self, std::string_view key)
+{
+    self.load();
+    auto const keyHash = MapKey::hashOf(key);
+    return std::find_if(self.elements.begin(), self.elements.end(),
+                        [keyHash, key] (Element const& elem) { return elem.key.matches(keyHash, key); });
+}
+
+template <typename T>
+auto Map<T>::findElement(this auto && self, MapKey const& key)
+{
+    self.load();
+    return std::find_if(self.elements.begin(), self.elements.end(),
+                        [&key] (Element const& elem) { return elem.key == key; });
+}
+
 template <typename T>
 template <std::invocable<Object::Operation, Map<T> const&, T const&, std::string_view> Lambda>
 ListenerToken Map<T>::addListener(Lambda && lambda)
 {
-    ListenerToken token(ListenerToken::private_constructor_t{});
-
-    // Add the listener to the vector
-    mapListeners.emplace(std::weak_ptr<ListenerToken::Impl>(token.token), std::move(lambda));
-    return token;
+    return mapListeners.add(std::move(lambda));
 }
 
 template <typename T>
@@ -1072,13 +1943,6 @@ template <typename T>
 template <class Context, std::invocable<Object::Operation, Map<T> const&, T const&, std::string_view> Lambda>
 void Map<T>::addListener(std::weak_ptr<Context> && context, Lambda && lambda)
 {
-    // Clean up expired managed listeners first
-    managedMapListeners.erase(
-        std::remove_if(managedMapListeners.begin(), managedMapListeners.end(),
-            [](auto const& ml) { return ml.context.expired(); }),
-        managedMapListeners.end()
-    );
-
     // Capture the weak_ptr and wrap the lambda
     auto wrappedLambda = [weakCtx = context, userLambda = std::move(lambda)]
                         (Operation op, Map<T> const& map, T const& val, std::string_view key)
@@ -1087,9 +1951,8 @@ void Map<T>::addListener(std::weak_ptr<Context> && context, Lambda && lambda)
             userLambda(op, map, val, key);
     };
 
-    // Add the token-based listener and store the token
-    auto token = addListener(std::move(wrappedLambda));
-    managedMapListeners.push_back({std::weak_ptr<void>(context), std::move(token)});
+    // The list keeps the listener until the context expires
+    mapListeners.add(std::weak_ptr<void>(context), std::move(wrappedLambda));
 }
 
 #if JUCE_SUPPORT
@@ -1097,13 +1960,6 @@ template <typename T>
 template <class ComponentType, std::invocable<Object::Operation, Map<T> const&, T const&, std::string_view> Lambda>
 void Map<T>::addListener(ComponentType* context, Lambda && lambda) requires std::is_base_of_v<juce::Component, ComponentType>
 {
-    // Clean up expired managed listeners first
-    managedMapListeners.erase(
-        std::remove_if(managedMapListeners.begin(), managedMapListeners.end(),
-            [](auto const& ml) { return ml.context.expired(); }),
-        managedMapListeners.end()
-    );
-
     // Create a SafePointer and wrap the lambda
     juce::Component::SafePointer<ComponentType> safeContext(context);
     auto wrappedLambda = [safeContext, userLambda = std::move(lambda)]
@@ -1113,9 +1969,8 @@ void Map<T>::addListener(ComponentType* context, Lambda && lambda) requires std:
             userLambda(op, map, val, key);
     };
 
-    // Add the token-based listener and store the token
-    auto token = addListener(std::move(wrappedLambda));
-    managedMapListeners.push_back({std::weak_ptr<void>(), std::move(token)});
+    // JUCE components have no weak_ptr: the SafePointer tells when to drop the listener
+    mapListeners.addWhile([safeContext] { return safeContext.getComponent() != nullptr; }, std::move(wrappedLambda));
 }
 #endif
 
@@ -1127,32 +1982,35 @@ auto Map<T>::typeErasedFields_internal(this auto && self)
     using ReturnType = std::vector<std::reference_wrapper<ElementType>>;
 
     ReturnType returnValue;
-    for (auto& element : self.elements)
+    for (auto& element : self.loadedElements())
         returnValue.emplace_back(element);
 
     return returnValue;
 }
 
 template <typename T>
-Map<T>::Element::Element(std::string_view fieldName_, Map& container_) : fieldName(fieldName_)
+Map<T>::Element::Element(MapKey key_, Map& container_) : key(std::move(key_))
 {
     init(container_);
 }
 
 template <typename T>
-Map<T>::Element::Element(Element const& o) : Base(o),  fieldName(o.fieldName)
+Map<T>::Element::Element(Element const& o) : Base(o),  key(o.key)
 {
     init(static_cast<Map<T>&>(*o.parent));
+
+    // elements are only copied when the container relocates them
+    this->copyVersionsFrom(o);
 }
 
 template <typename T>
-Map<T>::Element::Element(std::string_view fieldName_, Map& container_, T const& underlying_) : Base(underlying_), fieldName(fieldName_)
+Map<T>::Element::Element(MapKey key_, Map& container_, T const& underlying_) : Base(underlying_), key(std::move(key_))
 {
     init(container_);
 }
 
 template <typename T>
-Map<T>::Element::Element(std::string_view fieldName_, Map& container_, T && underlying_) : Base(std::move(underlying_)), fieldName(fieldName_)
+Map<T>::Element::Element(MapKey key_, Map& container_, T && underlying_) : Base(std::move(underlying_)), key(std::move(key_))
 {
     init(container_);
 }
@@ -1161,7 +2019,10 @@ template <typename T>
 typename Map<T>::Element& Map<T>::Element::operator=(Element const& o)
 {
     Base::operator=(o);
-    fieldName = o.fieldName;
+    key = o.key;
+
+    // elements are only assigned when the container relocates them
+    this->copyVersionsFrom(o);
     return *this;
 }
 
@@ -1182,7 +2043,7 @@ typename Map<T>::Element& Map<T>::Element::operator=(T && t)
 template <typename T>
 std::string Map<T>::Element::fieldname() const
 {
-    return fieldName;
+    return std::string(key.view());
 }
 
 template <typename T>
@@ -1192,22 +2053,21 @@ void Map<T>::Element::init(Map& container_)
 }
 
 template <typename T>
-void Map<T>::callListeners(Operation op, T const& newValue, std::string_view key) const
+void Map<T>::callListeners(Operation op, T const& newValue, std::string_view key)
 {
-    std::erase_if(mapListeners, [] (auto const& p) { return p.first.expired(); });
+    // elements are always added at the back
+    if (op == Operation::add)
+        elements.back().markChanged();
 
-    for (auto& [token, listener] : mapListeners)
-    {
-        // we need to check if the token expired again, becaus other listeners may have caused it to be expired
-        if (token.expired())
-            continue;
+    if (auto const hooked = markChanged(); ! isInAssignedRecord())
+        runFieldHooks(hooked);
 
-        listener(op, *this, newValue, key);
-    }
+    mapListeners.call(op, *this, newValue, key);
 
+    if (auto const kinds = propagateChildChange())
     {
         std::conditional_t<Fundamental<T>::kIsOpaque, Fundamental<T>, Record<T>> newValueTypeErased(newValue);
-        callChildListeners(std::vector<std::string>(1, std::string(key)), op, *this, newValueTypeErased);
+        notifyChildChange(kinds, std::string(key), op, newValueTypeErased);
     }
 }
 
@@ -1220,22 +2080,39 @@ bool Map<T>::assign(Value const& unsafeOther)
     
     auto const& other = static_cast<Map const&>(unsafeOther);
 
+    load();
+
     while (elements.size())
-        removeElement(elements[elements.size() - 1].fieldName);
+        removeElementAt(std::prev(elements.end()));
 
-    for (auto const& otherElement : other.elements)
-        addElement(otherElement.fieldName, static_cast<T>(otherElement));
+    for (auto const& otherElement : other.loadedElements())
+        addElement(otherElement.key, static_cast<T>(otherElement));
 
     return true;
 }
 
+template <typename T>
+std::uint64_t Map<T>::contentHash() const
+{
+    return cachedContentHash([this]
+    {
+        auto const& elems = loadedElements();
+        auto hash = detail::fnv1a(elems.size(), detail::SchemaHash<Map>::value);
+
+        for (auto const& element : elems)
+            hash = detail::fnv1a(element.contentHash(), detail::fnv1a(element.key.view(), hash));
+
+        return hash;
+    });
+}
+
 template <typename T>
 bool Map<T>::assignChild(std::string const& name, Value const& newValue)
 {
     if (newValue.type() != typeid(T))
         return false;
 
-    auto it = std::find_if(elements.begin(), elements.end(), [name] (Element const& elem) { return elem.fieldName == name; });
+    auto it = findElement(name);
 
     if (it != elements.end())
         return it->assign(newValue);
@@ -1247,19 +2124,26 @@ bool Map<T>::assignChild(std::string const& name, Value const& newValue)
 template <typename T>
 bool Map<T>::removeChild(std::string const& name)
 {
-    auto it = std::find_if(elements.begin(), elements.end(), [name] (Element const& elem) { return elem.fieldName == name; });
+    auto it = findElement(name);
     if (it == elements.end())
         return false;
 
-    removeElement(name);
+    removeElementAt(it);
     return true;
 }
 template <typename T>
 bool operator==(Map<T> const& amap, Map<T> const& bmap)
 {
-    auto const n = amap.elements.size();
+    if (amap.lazyPending && bmap.lazyPending && amap.lazySource == bmap.lazySource)
+        return true;
 
-    if (n != bmap.elements.size())
+    // O(1) if both hashes were computed before: different hashes prove inequality, equal hashes prove nothing
+    if (auto const ahash = amap.cachedContentHash(), bhash = bmap.cachedContentHash(); ahash && bhash && *ahash != *bhash)
+        return false;
+
+    auto const n = amap.loadedElements().size();
+
+    if (n != bmap.loadedElements().size())
         return false;
 
     for (std::size_t i = 0; i < n; ++i)
@@ -1267,10 +2151,10 @@ bool operator==(Map<T> const& amap, Map<T> const& bmap)
         auto const& a = amap.elements[i];
         auto const& b = bmap.elements[i];
 
-        if (a.fieldName != b.fieldName)
+        if (a.key != b.key)
             return false;
 
-        if (a != b)
+        if (! detail::values_equal<T>(a, b))
             return false;
     }
 
@@ -1286,24 +2170,73 @@ namespace dynamic
 // Field implementations
 //=============================================================================
 
-template <typename T, fixstr::fixed_string Name>
-Field<T, Name>& Field<T, Name>::operator=(T const& t)
+template <typename T, fixstr::fixed_string Name, typename Hooks>
+Field<T, Name, Hooks>& Field<T, Name, Hooks>::operator=(T const& t)
 {
-    Base::operator=(t);
+    if constexpr (kHasHooks)
+        this->template setField<Field>(t);
+    else
+        Base::operator=(t);
+
     return *this;
 }
 
-template <typename T, fixstr::fixed_string Name>
-Field<T, Name>& Field<T, Name>::operator=(T && t)
+template <typename T, fixstr::fixed_string Name, typename Hooks>
+Field<T, Name, Hooks>& Field<T, Name, Hooks>::operator=(T && t)
 {
-    Base::operator=(std::move(t));
+    if constexpr (kHasHooks)
+        this->template setField<Field>(std::move(t));
+    else
+        Base::operator=(std::move(t));
+
+    return *this;
+}
+
+template <typename T, fixstr::fixed_string Name, typename Hooks>
+std::string Field<T, Name, Hooks>::fieldname() const
+{
+    return std::string(kFieldName);
+}
+
+//=============================================================================
+// Computed implementations
+//=============================================================================
+
+template <typename T, fixstr::fixed_string Name, typename Function, fixstr::fixed_string... Dependencies>
+Computed<T, Name, Function, Dependencies...>& Computed<T, Name, Function, Dependencies...>::operator=(Computed const& o)
+{
+    o.refresh();
+    Base::operator=(o);
+    return *this;
+}
+
+template <typename T, fixstr::fixed_string Name, typename Function, fixstr::fixed_string... Dependencies>
+Computed<T, Name, Function, Dependencies...>& Computed<T, Name, Function, Dependencies...>::operator=(Computed&& o)
+{
+    o.refresh();
+    Base::operator=(std::move(o));
     return *this;
 }
 
-template <typename T, fixstr::fixed_string Name>
-std::string Field<T, Name>::fieldname() const
+template <typename T, fixstr::fixed_string Name, typename Function, fixstr::fixed_string... Dependencies>
+template <typename... Fields>
+T Computed<T, Name, Function, Dependencies...>::compute(Fields const&... dependencies)
+{
+    return std::invoke([&dependencies...] <typename... Args> (std::type_identity<std::tuple<Args...>>)
+    {
+        return static_cast<T>(Function{}(argument<Args>(dependencies)...));
+    }, std::type_identity<typename detail::call_arguments<Function>::type>());
+}
+
+template <typename T, fixstr::fixed_string Name, typename Function, fixstr::fixed_string... Dependencies>
+template <typename Arg, typename FieldType>
+decltype(auto) Computed<T, Name, Function, Dependencies...>::argument(FieldType const& field)
 {
-    return std::string(std::string_view(Name));
+    // containers are their own field base, everything else wraps an Arg
+    if constexpr (std::is_same_v<detail::BaseTypeFor<Arg>, Arg>)
+        return static_cast<Arg const&>(field);
+    else
+        return field();
 }
 
 //=============================================================================
@@ -1313,6 +2246,84 @@ std::string Field<T, Name>::fieldname() const
 namespace detail
 {
 
+/// Canonical name of a leaf type
+template <typename T>
+constexpr std::string_view leaf_type_name()
+{
+    if constexpr (std::is_same_v<T, int8_t>)             return "int8";
+    else if constexpr (std::is_same_v<T, int16_t>)       return "int16";
+    else if constexpr (std::is_same_v<T, int32_t>)       return "int32";
+    else if constexpr (std::is_same_v<T, int64_t>)       return "int64";
+    else if constexpr (std::is_same_v<T, uint8_t>)       return "uint8";
+    else if constexpr (std::is_same_v<T, uint16_t>)      return "uint16";
+    else if constexpr (std::is_same_v<T, uint32_t>)      return "uint32";
+    else if constexpr (std::is_same_v<T, uint64_t>)      return "uint64";
+    else if constexpr (std::is_same_v<T, float>)         return "float";
+    else if constexpr (std::is_same_v<T, double>)        return "double";
+    else if constexpr (std::is_same_v<T, long double>)   return "long double";
+    else if constexpr (std::is_same_v<T, bool>)          return "bool";
+    else if constexpr (std::is_same_v<T, std::string>)   return "string";
+    else if constexpr (std::is_same_v<T, ID>)            return "ID";
+    else                                                 return type_name<T>();
+}
+
+/// Name of a record type: the name given to DYNAMIC_REGISTER_RECORD or the compiler generated one
+template <typename T>
+constexpr std::string_view record_type_name()
+{
+    if constexpr (requires { { RecordName<T>::value } -> std::convertible_to<std::string_view>; })
+        return RecordName<T>::value;
+    else
+        return type_name<T>();
+}
+
+/// Hashes the in-memory representation of leaf type T into seed: leaves which are copied byte-wise must agree on it
+template <typename T>
+constexpr std::uint64_t leaf_representation_hash(std::uint64_t seed)
+{
+    if constexpr (std::is_trivially_copyable_v<T>)
+        seed = fnv1a(alignof(T), fnv1a(sizeof(T), seed));
+
+    // e.g. long double is the x87 80-bit format on some platforms and binary128 or a double on others
+    if constexpr (std::is_floating_point_v<T>)
+        seed = fnv1a(static_cast<std::uint64_t>(std::numeric_limits<T>::max_exponent), fnv1a(static_cast<std::uint64_t>(std::numeric_limits<T>::digits), seed));
+
+    return seed;
+}
+
+/// Structural schema hash of T, see MetaType::schemaHash()
+template <typename T>
+struct SchemaHash
+{
+    static constexpr std::uint64_t compute()
+    {
+        if constexpr (Value::isOpaque<T>())
+        {
+            return leaf_representation_hash<T>(fnv1a(leaf_type_name<T>(), fnv1a("leaf")));
+        }
+        else
+        {
+            using FieldsTuple = typename Record<T>::FieldsAsTuple;
+
+            return std::invoke([] <std::size_t... Is> (std::index_sequence<Is...>)
+            {
+                auto hash = fnv1a(sizeof...(Is), fnv1a("record"));
+                ((hash = fnv1a(SchemaHash<field_value_type_t<std::tuple_element_t<Is, FieldsTuple>>>::value,
+                               fnv1a(Record<T>::kFieldNames[Is], fnv1a(Record<T>::kFieldNames[Is].size(), hash)))), ...);
+                return hash;
+            }, std::make_index_sequence<std::tuple_size_v<FieldsTuple>>());
+        }
+    }
+
+    static constexpr std::uint64_t value = compute();
+};
+
+template <typename T>
+struct SchemaHash<Array<T>> { static constexpr std::uint64_t value = fnv1a(SchemaHash<T>::value, fnv1a("Array")); };
+
+template <typename T>
+struct SchemaHash<Map<T>> { static constexpr std::uint64_t value = fnv1a(SchemaHash<T>::value, fnv1a("Map")); };
+
 /// MetaType for Invalid (void type)
 class InvalidMeta final : public MetaType
 {
@@ -1320,6 +2331,8 @@ public:
     std::type_info const& typeInfo() const override { return typeid(void); }
     bool isOpaque() const override { return true; }
     std::unique_ptr<Value> construct() const override { return nullptr; }
+    std::string_view name() const override { return "invalid"; }
+    std::uint64_t schemaHash() const override { return 0; }
 };
 
 inline MetaType const& invalidMetaType()
@@ -1335,6 +2348,8 @@ class FundamentalMeta final : public MetaType
 public:
     std::type_info const& typeInfo() const override { return typeid(T); }
     bool isOpaque() const override { return true; }
+    std::string_view name() const override { return leaf_type_name<T>(); }
+    std::uint64_t schemaHash() const override { return SchemaHash<T>::value; }
 
     std::unique_ptr<Value> construct() const override
     {
@@ -1348,6 +2363,52 @@ class RecordMeta final : public MetaType
 {
     using FieldsTuple = typename Record<T>::FieldsAsTuple;
     static constexpr auto kNumFields = std::tuple_size_v<FieldsTuple>;
+    static constexpr auto kFieldMemberIndices = field_member_indices<T>();
+
+    /// Default constructed instance on which the field offsets are measured
+    static T const& sample()
+    {
+        static T const instance{};
+        return instance;
+    }
+
+    /// Instance-free accessors of the I-th field
+    template <std::size_t I>
+    struct FieldAccess
+    {
+        static constexpr auto kMemberIndex = kFieldMemberIndices[I];
+        using FieldType = std::tuple_element_t<I, FieldsTuple>;
+        using ValueType = field_value_type_t<FieldType>;
+
+        static FieldType& field(void* object)             { return boost::pfr::get<kMemberIndex>(*static_cast<T*>(object)); }
+        static FieldType const& field(void const* object) { return boost::pfr::get<kMemberIndex>(*static_cast<T const*>(object)); }
+
+        static Value& typeErasedField(void* object)             { return field(object); }
+        static Value const& typeErasedField(void const* object) { return field(object); }
+
+        /// Measured rather than computed, so alignas, [[no_unique_address]] and packed members are handled
+        static std::size_t offset()
+        {
+            auto const* base = reinterpret_cast<char const*>(std::addressof(sample()));
+            return static_cast<std::size_t>(reinterpret_cast<char const*>(std::addressof(field(std::addressof(sample())))) - base);
+        }
+
+        static void get(void const* object, void* out)
+        {
+            auto const& fld = field(object);
+
+            // containers are their own field base, everything else wraps a ValueType
+            if constexpr (std::is_base_of_v<ValueType, FieldType>)
+                *static_cast<ValueType*>(out) = static_cast<ValueType const&>(fld);
+            else
+                *static_cast<ValueType*>(out) = fld();
+        }
+
+        static void set(void* object, void const* in)
+        {
+            field(object) = *static_cast<ValueType const*>(in);
+        }
+    };
 
     template <std::size_t... Is>
     static std::array<FieldDescriptor, kNumFields> makeDescriptors(std::index_sequence<Is...>)
@@ -1355,15 +2416,26 @@ class RecordMeta final : public MetaType
         return {{
             FieldDescriptor{
                 Record<T>::kFieldNames[Is],
-                &metaTypeOf<field_value_type_t<std::tuple_element_t<Is, FieldsTuple>>>
+                &metaTypeOf<field_value_type_t<std::tuple_element_t<Is, FieldsTuple>>>,
+                FieldAccess<Is>::offset(),
+                sizeof(typename FieldAccess<Is>::ValueType),
+                static_cast<Value& (*)(void*)>(&FieldAccess<Is>::typeErasedField),
+                static_cast<Value const& (*)(void const*)>(&FieldAccess<Is>::typeErasedField),
+                &FieldAccess<Is>::get,
+                &FieldAccess<Is>::set
             }...
         }};
     }
 
 public:
+    /// Adds every instantiated record type to the MetaTypeRegistry during static initialization
+    static inline bool const kRegistered = (MetaTypeRegistry::add(metaTypeOf<T>()), true);
+
     std::type_info const& typeInfo() const override { return typeid(T); }
     bool isOpaque() const override { return false; }
     bool isRecord() const override { return true; }
+    std::string_view name() const override { return record_type_name<T>(); }
+    std::uint64_t schemaHash() const override { return SchemaHash<T>::value; }
 
     std::span<FieldDescriptor const> fields() const override
     {
@@ -1391,6 +2463,14 @@ public:
         return &metaTypeOf<T>();
     }
 
+    std::string_view name() const override
+    {
+        static std::string const kName = "Array<" + std::string(metaTypeOf<T>().name()) + ">";
+        return kName;
+    }
+
+    std::uint64_t schemaHash() const override { return SchemaHash<Array<T>>::value; }
+
     std::unique_ptr<Value> construct() const override
     {
         return std::make_unique<Array<T>>();
@@ -1411,6 +2491,14 @@ public:
         return &metaTypeOf<T>();
     }
 
+    std::string_view name() const override
+    {
+        static std::string const kName = "Map<" + std::string(metaTypeOf<T>().name()) + ">";
+        return kName;
+    }
+
+    std::uint64_t schemaHash() const override { return SchemaHash<Map<T>>::value; }
+
     std::unique_ptr<Value> construct() const override
     {
         return std::make_unique<Map<T>>();
@@ -1426,6 +2514,7 @@ struct MetaTypeHelper
         if constexpr (! Value::isOpaque<T>())
         {
             static RecordMeta<T> instance;
+            static_cast<void>(RecordMeta<T>::kRegistered);
             return instance;
         }
         else
@@ -1525,7 +2614,12 @@ MetaType const& Map<T>::metaType() const
 
 inline std::ostream& operator<<(std::ostream& o, Value const& x)
 {
-    x.visit([&o] (auto const& underlying) { o << underlying; });
+    x.visit([&o] (auto const& underlying)
+    {
+        // user registered fundamental types may not be streamable
+        if constexpr (requires { o << underlying; })
+            o << underlying;
+    });
     return o;
 }
 
@@ -1533,14 +2627,13 @@ inline std::ostream& operator<<(std::ostream& o, Object const& x)
 {
     o << "{ ";
     auto first = true;
-    auto const& fields = x.typeErasedFields();
 
-    for (auto const& fld : fields)
+    for (auto const& fld : x.fieldRange())
     {
         if (! std::exchange(first, false))
             o << ", ";
 
-        o << "." << fld.get().fieldname() << " = " << fld.get();
+        o << "." << fld.fieldname() << " = " << fld;
     }
 
     o << " }";
@@ -1569,8 +2662,24 @@ template<typename CharT>
 template<class FmtContext>
 FmtContext::iterator std::formatter<dynamic::Value, CharT>::format(dynamic::Value const& v, FmtContext& ctx) const
 {
-    return v.visit([&ctx] (auto const& underlying)
+    return v.visit([&ctx] (auto const& underlying) -> typename FmtContext::iterator
     {
-        return std::formatter<std::remove_cvref_t<decltype(underlying)>, CharT>{}.format(underlying, ctx);
+        using U = std::remove_cvref_t<decltype(underlying)>;
+
+        // user registered fundamental types may only support operator<< or no output at all
+        if constexpr (std::formattable<U, CharT>)
+        {
+            return std::formatter<U, CharT>{}.format(underlying, ctx);
+        }
+        else if constexpr (requires (std::ostream& o) { o << underlying; })
+        {
+            std::ostringstream ss;
+            ss << underlying;
+            return std::formatter<std::string, CharT>{}.format(ss.str(), ctx);
+        }
+        else
+        {
+            return ctx.out();
+        }
     });
 }
@@ -0,0 +1,465 @@
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "dynamic.hpp"
+#include "dynamic_parallel.hpp"
+#include "dynamic_concurrent.hpp"
+#include "dynamic_ring.hpp"
+
+// Micro benchmarks for hot paths of the dynamic library.
+// Build in Release mode and run the dynamic_bench executable.
+using namespace dynamic;
+
+namespace
+{
+
+template <typename Lambda>
+double measure(std::size_t iterations, Lambda && lambda)
+{
+    auto const start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+        lambda();
+
+    auto const end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(iterations);
+}
+
+void report(std::string_view name, double nanosecondsPerOp)
+{
+    std::cout << "  " << name << ": " << nanosecondsPerOp << " ns/op" << std::endl;
+}
+
+// Prevent the optimizer from removing benchmarked work
+template <typename T>
+void doNotOptimize(T const& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+//=============================================================================
+// Reference implementation of the previous visit() dispatch: a virtual
+// function building a std::variant of reference_wrappers which is then
+// dispatched with std::visit.
+//=============================================================================
+namespace legacy
+{
+using Variant = std::variant<std::reference_wrapper<int8_t>, std::reference_wrapper<int16_t>, std::reference_wrapper<int32_t>,
+                             std::reference_wrapper<int64_t>, std::reference_wrapper<float>, std::reference_wrapper<double>,
+                             std::reference_wrapper<bool>, std::reference_wrapper<std::string>, std::reference_wrapper<ID>>;
+
+struct Base
+{
+    virtual ~Base() = default;
+    virtual bool isValid() const { return true; }
+    virtual bool isStruct() const { return false; }
+    virtual Variant visit_helper() = 0;
+};
+
+template <typename T>
+struct Leaf : Base
+{
+    explicit Leaf(T v) : underlying(std::move(v)) {}
+    Variant visit_helper() override { return std::reference_wrapper<T>(underlying); }
+    T underlying;
+};
+
+// previous const visit: hands out a const reference to the underlying value
+template <typename Lambda>
+void visit(Base const& self, Lambda && lambda)
+{
+    if (! self.isValid() || self.isStruct())
+        return;
+
+    std::visit([&lambda] <typename T> (std::reference_wrapper<T> v)
+    {
+        if constexpr (std::is_invocable_v<Lambda, T const&>)
+            lambda(std::as_const(v.get()));
+    }, const_cast<Base&>(self).visit_helper());
+}
+
+template <typename Lambda>
+void visit(Base& self, Lambda && lambda)
+{
+    if (! self.isValid() || self.isStruct())
+        return;
+
+    std::visit([&lambda] <typename T> (std::reference_wrapper<T> v)
+    {
+        if constexpr (std::is_invocable_v<Lambda, T&>)
+        {
+            // previous mutable visit: copy, mutate the copy and assign back
+            T copy(v.get());
+            lambda(copy);
+            v.get() = copy;
+        }
+    }, self.visit_helper());
+}
+} // namespace legacy
+
+void benchmarkVisit()
+{
+    std::cout << "visit() dispatch" << std::endl;
+
+    static constexpr std::size_t kNumValues = 1024;
+    static constexpr std::size_t kIterations = 2000;
+
+    std::vector<std::unique_ptr<Value>> values;
+    std::vector<std::unique_ptr<legacy::Base>> legacyValues;
+
+    for (std::size_t i = 0; i < kNumValues; ++i)
+    {
+        switch (i % 3)
+        {
+        case 0:
+            values.push_back(std::make_unique<Fundamental<int32_t>>(static_cast<int32_t>(i)));
+            legacyValues.push_back(std::make_unique<legacy::Leaf<int32_t>>(static_cast<int32_t>(i)));
+            break;
+        case 1:
+            values.push_back(std::make_unique<Fundamental<double>>(static_cast<double>(i)));
+            legacyValues.push_back(std::make_unique<legacy::Leaf<double>>(static_cast<double>(i)));
+            break;
+        default:
+            values.push_back(std::make_unique<Fundamental<float>>(static_cast<float>(i)));
+            legacyValues.push_back(std::make_unique<legacy::Leaf<float>>(static_cast<float>(i)));
+            break;
+        }
+    }
+
+    double sum = 0.0;
+    auto const sumArithmetic = [&sum] (auto const& v)
+    {
+        if constexpr (std::is_arithmetic_v<std::remove_cvref_t<decltype(v)>>)
+            sum += static_cast<double>(v);
+    };
+
+    auto const legacyConst = measure(kIterations, [&]
+    {
+        for (auto const& v : legacyValues)
+            legacy::visit(static_cast<legacy::Base const&>(*v), sumArithmetic);
+    });
+
+    auto const currentConst = measure(kIterations, [&]
+    {
+        for (auto const& v : values)
+            static_cast<Value const&>(*v).visit(sumArithmetic);
+    });
+
+    doNotOptimize(sum);
+
+    auto const increment = [] (auto& v)
+    {
+        if constexpr (std::is_arithmetic_v<std::remove_cvref_t<decltype(v)>>)
+            v += 1;
+    };
+
+    auto const legacyMutable = measure(kIterations, [&]
+    {
+        for (auto& v : legacyValues)
+            legacy::visit(*v, increment);
+    });
+
+    auto const currentMutable = measure(kIterations, [&]
+    {
+        for (auto& v : values)
+            v->visit(increment);
+    });
+
+    auto const perValue = [] (double ns) { return ns / static_cast<double>(kNumValues); };
+    report("variant dispatch (reference, read)", perValue(legacyConst));
+    report("jump table dispatch (read)", perValue(currentConst));
+    report("variant dispatch (reference, copy + assign back)", perValue(legacyMutable));
+    report("jump table dispatch (in place + notify)", perValue(currentMutable));
+}
+
+//=============================================================================
+// Deep copy of a large state: copy constructor vs. parallelCopy()
+//=============================================================================
+struct Sample
+{
+    Field<double, "time"> time;
+    Field<float, "value"> value;
+    Field<std::string, "label"> label;
+};
+
+struct Channel
+{
+    Field<std::string, "name"> name;
+    Field<Array<Sample>, "samples"> samples;
+};
+
+struct Recording
+{
+    Field<Array<Channel>, "channels"> channels;
+    Field<Map<int32_t>, "counters"> counters;
+};
+
+constexpr std::size_t kNumChannels = 64;
+constexpr std::size_t kNumSamples = 4096;
+
+void fillRecording(Record<Recording>& recording)
+{
+    for (std::size_t c = 0; c < kNumChannels; ++c)
+    {
+        recording("channels"_fld).addElement(Channel{});
+        auto& channel = recording("channels"_fld)[c];
+        channel("name"_fld) = "channel " + std::to_string(c);
+
+        for (std::size_t s = 0; s < kNumSamples; ++s)
+        {
+            Sample sample;
+            sample.time = static_cast<double>(s);
+            sample.value = static_cast<float>(c * s);
+            sample.label = "sample";
+            channel("samples"_fld).addElement(std::move(sample));
+        }
+
+        recording("counters"_fld).addElement("counter " + std::to_string(c), static_cast<int32_t>(c));
+    }
+}
+
+void benchmarkParallelCopy()
+{
+    std::cout << "deep copy (64 channels x 4096 samples)" << std::endl;
+
+    static constexpr std::size_t kIterations = 5;
+
+    Record<Recording> recording;
+    fillRecording(recording);
+
+    auto const serial = measure(kIterations, [&]
+    {
+        Record<Recording> copy(recording);
+        doNotOptimize(copy);
+    });
+
+    report("copy constructor", serial);
+
+    for (std::size_t threads : { 1, 2, 4, 8 })
+    {
+        ThreadPool pool(threads);
+
+        auto const parallel = measure(kIterations, [&]
+        {
+            auto copy = parallelCopy(recording, pool);
+            doNotOptimize(copy);
+        });
+
+        report("parallelCopy, " + std::to_string(threads) + " thread(s)", parallel);
+    }
+}
+
+//=============================================================================
+// Read-only visit of all leaves: recursive typeErasedFields() vs. parallelVisitLeaves()
+//=============================================================================
+void sumLeaves(Value const& value, double& sum)
+{
+    if (! value.isStruct())
+    {
+        value.visit([&sum] (std::floating_point auto x) { sum += static_cast<double>(x); });
+        return;
+    }
+
+    for (auto const& child : static_cast<Object const&>(value).typeErasedFields())
+        sumLeaves(child.get(), sum);
+}
+
+void benchmarkParallelVisit()
+{
+    std::cout << "leaf visit (64 channels x 4096 samples)" << std::endl;
+
+    static constexpr std::size_t kIterations = 10;
+
+    Record<Recording> recording;
+    fillRecording(recording);
+
+    auto const serial = measure(kIterations, [&]
+    {
+        double sum = 0.0;
+        sumLeaves(recording, sum);
+        doNotOptimize(sum);
+    });
+
+    report("recursive typeErasedFields()", serial);
+
+    for (std::size_t threads : { 1, 2, 4, 8 })
+    {
+        ThreadPool pool(threads);
+
+        auto const parallel = measure(kIterations, [&]
+        {
+            parallelVisitLeaves(recording, [] (Value const& leaf)
+            {
+                double sum = 0.0;
+                leaf.visit([&sum] (std::floating_point auto x) { sum += static_cast<double>(x); });
+                doNotOptimize(sum);
+            }, pool);
+        });
+
+        report("parallelVisitLeaves, " + std::to_string(threads) + " thread(s)", parallel);
+    }
+}
+
+//=============================================================================
+// Multi-writer ingest: Map<T> behind one mutex vs. ConcurrentMap<T>
+//=============================================================================
+struct Quote
+{
+    Field<double, "bid"> bid;
+    Field<double, "ask"> ask;
+};
+
+struct Market
+{
+    Field<Map<Quote>, "quotes"> quotes;
+    Field<ConcurrentMap<Quote>, "sharded"> sharded;
+};
+
+void benchmarkConcurrentMap()
+{
+    std::cout << "ingest (4096 keys, 16 updates per key)" << std::endl;
+
+    static constexpr std::size_t kNumKeys = 4096;
+    static constexpr std::size_t kUpdatesPerKey = 16;
+
+    Record<Market> market;
+    std::vector<std::string> keys;
+
+    for (std::size_t k = 0; k < kNumKeys; ++k)
+    {
+        keys.push_back("SYM" + std::to_string(k));
+        market("quotes"_fld).addElement(keys.back(), Quote{});
+        market("sharded"_fld).insertOrAssign(keys.back(), Quote{});
+    }
+
+    // every writer updates its own slice of the keys
+    auto const ingest = [&keys] (std::size_t threads, auto const& updateKey)
+    {
+        std::vector<std::thread> writers;
+
+        for (std::size_t t = 0; t < threads; ++t)
+        {
+            writers.emplace_back([&keys, &updateKey, t, threads]
+            {
+                for (std::size_t u = 0; u < kUpdatesPerKey; ++u)
+                    for (auto k = t; k < keys.size(); k += threads)
+                        updateKey(keys[k], static_cast<double>(u));
+            });
+        }
+
+        for (auto& writer : writers)
+            writer.join();
+    };
+
+    for (std::size_t threads : { 1, 2, 4, 8 })
+    {
+        std::mutex mutex;
+
+        auto const funnelled = measure(1, [&]
+        {
+            ingest(threads, [&] (std::string const& key, double bid)
+            {
+                std::lock_guard lock(mutex);
+                market("quotes"_fld)[key]("bid"_fld) = bid;
+            });
+        });
+
+        auto const sharded = measure(1, [&]
+        {
+            ingest(threads, [&] (std::string const& key, double bid)
+            {
+                market("sharded"_fld).update(key, [bid] (Record<Quote>& quote) { quote("bid"_fld) = bid; });
+            });
+        });
+
+        auto const updates = static_cast<double>(kNumKeys * kUpdatesPerKey);
+        report("Map<T> + mutex, " + std::to_string(threads) + " thread(s)", funnelled / updates);
+        report("ConcurrentMap<T>, " + std::to_string(threads) + " thread(s)", sharded / updates);
+    }
+}
+
+//=============================================================================
+// Cross-thread change delivery: mutex + deque vs. EventRing
+//=============================================================================
+void benchmarkEventRing()
+{
+    std::cout << "deliver changes to a consumer thread (1M leaf changes)" << std::endl;
+
+    static constexpr int kNumChanges = 1000000;
+
+    // the writer changes the leaf while a consumer thread takes out the changes
+    auto const run = [] (Record<Quote>& quote, auto const& consumeAll)
+    {
+        std::atomic<bool> done = false;
+        std::thread consumer([&] { while (! done.load()) consumeAll(); consumeAll(); });
+
+        auto const elapsed = measure(1, [&]
+        {
+            for (int i = 1; i <= kNumChanges; ++i)
+                quote("bid"_fld) = static_cast<double>(i);
+        });
+
+        done = true;
+        consumer.join();
+        return elapsed / kNumChanges;
+    };
+
+    {
+        struct Event { ID path; Object::Operation op; double value; };
+
+        Record<Quote> quote;
+        std::mutex mutex;
+        std::deque<Event> queue;
+
+        auto token = quote.addChildListener([&] (ID const& path, Object::Operation op, Object const&, Value const& value)
+        {
+            auto const bid = static_cast<Fundamental<double> const&>(value)();
+            std::lock_guard lock(mutex);
+            queue.push_back({ path, op, bid });
+        });
+
+        report("child listener + mutex + std::deque", run(quote, [&]
+        {
+            std::lock_guard lock(mutex);
+
+            while (! queue.empty())
+            {
+                doNotOptimize(queue.front().value);
+                queue.pop_front();
+            }
+        }));
+    }
+
+    {
+        Record<Quote> quote;
+        EventRing ring(quote, 4096);
+
+        report("EventRing", run(quote, [&]
+        {
+            ring.drain([] (RingEvent const& event) { doNotOptimize(event.bytes); });
+        }));
+
+        std::cout << "  (dropped " << ring.dropped() << ", high-water mark " << ring.highWaterMark() << ")" << std::endl;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    benchmarkVisit();
+    benchmarkParallelCopy();
+    benchmarkParallelVisit();
+    benchmarkConcurrentMap();
+    benchmarkEventRing();
+    return 0;
+}
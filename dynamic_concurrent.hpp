@@ -0,0 +1,448 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+#include "dynamic.hpp"
+
+namespace dynamic
+{
+
+/**
+ * @brief A map which can be written by several threads at once
+ *
+ * Keys are hashed to one of NumShards shards. Every shard is a Map<T> guarded
+ * by its own reader/writer lock, so writers of keys in different shards do not
+ * wait for each other, and lookups only search the shard of their key.
+ * ConcurrentMap is used as a field like Map<T>:
+ *
+ * @code
+ * struct Market
+ * {
+ *     Field<ConcurrentMap<Quote>, "quotes"> quotes;
+ * };
+ *
+ * // on any ingest thread
+ * market("quotes"_fld).insertOrAssign(symbol, quote);
+ * market("quotes"_fld).update(symbol, [&] (Record<Quote>& q) { q("bid"_fld) = bid; });
+ * @endcode
+ *
+ * Child listeners of the ConcurrentMap and of its parents are notified of
+ * changes with the same paths as for a Map<T> ("quotes/<key>/..."). Listeners
+ * are called on the writing thread, one at a time: changes to a shard are
+ * notified in the order they were made, changes to different shards in any
+ * order. Listeners must not access the ConcurrentMap, except via the values
+ * passed to them.
+ *
+ * Only the methods of this class lock. The type-erased Object interface used by
+ * generic code (typeErasedFields(), fieldAt(), getchild(), ...), copies and
+ * comparisons must not run concurrently with writers. Writers of the ConcurrentMap
+ * stamp the parts of the tree above it without locking, and notify them one at a
+ * time, but writes to those parts themselves are not synchronized.
+ *
+ * diff() and parallelCopy() handle a ConcurrentMap shard by shard, also without
+ * locking. The wire encoders and snapshots do not support it.
+ */
+template <typename T, std::size_t NumShards>
+class ConcurrentMap : public Object
+{
+    static_assert(NumShards >= 1, "A ConcurrentMap needs at least one shard");
+
+public:
+    /// The typed element type (Fundamental<T> for primitive T, Record<T> for struct T)
+    using ElementType = typename Map<T>::ElementType;
+
+    static constexpr std::size_t kNumShards = NumShards;
+
+    ConcurrentMap();
+
+    /// Copy constructor (does not copy listeners)
+    ConcurrentMap(ConcurrentMap const& o);
+
+    // assignment operator
+    ConcurrentMap& operator=(ConcurrentMap const& o)
+    {
+        auto status = assign(o);
+        assert(status);
+        (void)status;
+        return *this;
+    }
+
+    /**
+     * @brief Adds an element with key, or assigns value to the existing element
+     *
+     * Unlike Map<T>::addElement(), assigning to an existing element notifies
+     * listeners (with Operation::modify).
+     */
+    void insertOrAssign(std::string_view key, T value);
+
+    /**
+     * @brief Calls lambda(ElementType&) with the element with key, holding its shard's write lock
+     *
+     * @return False if there is no element with key
+     */
+    template <typename Lambda>
+    bool update(std::string_view key, Lambda && lambda);
+
+    /**
+     * @brief Calls lambda(ElementType const&) with the element with key, holding its shard's read lock
+     *
+     * @return False if there is no element with key
+     */
+    template <typename Lambda>
+    bool read(std::string_view key, Lambda && lambda) const;
+
+    /**
+     * @brief Removes the element with key
+     *
+     * @return False if there is no element with key
+     */
+    bool removeElement(std::string_view key);
+
+    /// Returns true if there is an element with key
+    bool contains(std::string_view key) const;
+
+    /// Returns the number of elements (locking one shard after the other)
+    std::size_t size() const;
+
+    /// Returns true if the map has no elements
+    bool empty() const { return size() == 0; }
+
+    /// Returns the index of the shard which holds key
+    static std::size_t shardOf(std::string_view key) { return static_cast<std::size_t>(MapKey::hashOf(key) % NumShards); }
+
+    /// Returns the type_info for ConcurrentMap<T, NumShards>
+    std::type_info const& type() const override { return typeid(ConcurrentMap); }
+
+    /// Returns the MetaType for ConcurrentMap<T, NumShards> (static, no instance needed)
+    static MetaType const& meta();
+
+    /// Returns the MetaType for this map type
+    MetaType const& metaType() const override { return meta(); }
+
+    /// Always returns true - maps are always valid containers
+    bool isValid() const override { return true; }
+
+    bool isMapOrArray() const override { return true; }
+    std::type_info const& elementType() const override { return typeid(T); }
+
+    /// Returns type-erased references to all values, shard after shard (const version)
+    std::vector<std::reference_wrapper<Value const>> typeErasedFields() const override;
+
+    /// Returns type-erased references to all values, shard after shard (mutable version)
+    std::vector<std::reference_wrapper<Value>> typeErasedFields() override;
+
+    std::size_t fieldCount() const override;
+    Value const& fieldAt(std::size_t idx) const override;
+    Value& fieldAt(std::size_t idx) override;
+
+    // overridden base methods
+    bool assign(Value const&) override;
+    std::uint64_t contentHash() const override;
+    bool assignChild(std::string const&, Value const&) override;
+    bool removeChild(std::string const&) override;
+
+    /// Two maps are equal if their shards are equal, i.e. if they hold the same elements in the same order per shard
+    friend bool operator==(ConcurrentMap const& a, ConcurrentMap const& b)
+    {
+        for (std::size_t idx = 0; idx < NumShards; ++idx)
+            if (! (a.shards[idx].map == b.shards[idx].map))
+                return false;
+
+        return true;
+    }
+
+private:
+    template <typename> friend struct detail::ParallelCopy;
+    template <typename> friend struct detail::diff::Differ;
+
+    struct Shard
+    {
+        mutable std::shared_mutex mutex;
+        Map<T> map;
+    };
+
+    Shard& shardFor(std::string_view key) { return shards[shardOf(key)]; }
+    Shard const& shardFor(std::string_view key) const { return shards[shardOf(key)]; }
+
+    /// Attaches the shards to this map
+    void init();
+
+    std::array<Shard, NumShards> shards;
+
+    // serializes running the hooks and listeners of this map and its parents
+    std::mutex propagationMutex;
+};
+
+//=============================================================================
+// Implementation details
+//=============================================================================
+namespace detail
+{
+
+/// ConcurrentMap hashes differently from Map: the encoders and snapshots do not support it
+template <typename T, std::size_t NumShards>
+struct SchemaHash<ConcurrentMap<T, NumShards>> { static constexpr std::uint64_t value = fnv1a(SchemaHash<T>::value, fnv1a("ConcurrentMap")); };
+
+template <typename T, std::size_t NumShards>
+struct has_exact_content_hash<ConcurrentMap<T, NumShards>> : has_exact_content_hash<T> {};
+
+/// MetaType for ConcurrentMap<T, NumShards>
+template <typename T, std::size_t NumShards>
+class ConcurrentMapMeta final : public MetaType
+{
+public:
+    std::type_info const& typeInfo() const override { return typeid(ConcurrentMap<T, NumShards>); }
+    bool isOpaque() const override { return false; }
+    bool isMap() const override { return true; }
+
+    MetaType const* elementMetaType() const override
+    {
+        return &metaTypeOf<T>();
+    }
+
+    std::string_view name() const override
+    {
+        static std::string const kName = "ConcurrentMap<" + std::string(metaTypeOf<T>().name()) + ">";
+        return kName;
+    }
+
+    std::uint64_t schemaHash() const override { return SchemaHash<ConcurrentMap<T, NumShards>>::value; }
+
+    std::unique_ptr<Value> construct() const override
+    {
+        return std::make_unique<ConcurrentMap<T, NumShards>>();
+    }
+};
+
+template <typename T, std::size_t NumShards>
+struct MetaTypeHelper<ConcurrentMap<T, NumShards>>
+{
+    static MetaType const& get()
+    {
+        static ConcurrentMapMeta<T, NumShards> instance;
+        return instance;
+    }
+};
+
+} // namespace detail
+
+//=============================================================================
+// ConcurrentMap implementations
+//=============================================================================
+template <typename T, std::size_t NumShards>
+ConcurrentMap<T, NumShards>::ConcurrentMap()
+{
+    init();
+}
+
+template <typename T, std::size_t NumShards>
+ConcurrentMap<T, NumShards>::ConcurrentMap(ConcurrentMap const& o) : Object(o)
+{
+    for (std::size_t idx = 0; idx < NumShards; ++idx)
+        shards[idx].map = o.shards[idx].map;
+
+    init();
+}
+
+template <typename T, std::size_t NumShards>
+void ConcurrentMap<T, NumShards>::init()
+{
+    // Shards are attached once and never appear in paths. Every shard notifies
+    // its own listeners under its own lock; above the shard, propagationMutex
+    // makes writers of different shards take turns.
+    for (auto& shard : shards)
+    {
+        shard.map.parent = this;
+        shard.map.sharedAncestorsMutex = &propagationMutex;
+    }
+}
+
+template <typename T, std::size_t NumShards>
+void ConcurrentMap<T, NumShards>::insertOrAssign(std::string_view key, T value)
+{
+    auto& shard = shardFor(key);
+    std::unique_lock lock(shard.mutex);
+
+    if (auto it = shard.map.find(key); it != shard.map.end())
+        *it = std::move(value);
+    else
+        shard.map.addElement(key, std::move(value));
+}
+
+template <typename T, std::size_t NumShards>
+template <typename Lambda>
+bool ConcurrentMap<T, NumShards>::update(std::string_view key, Lambda && lambda)
+{
+    auto& shard = shardFor(key);
+    std::unique_lock lock(shard.mutex);
+
+    auto it = shard.map.find(key);
+
+    if (it == shard.map.end())
+        return false;
+
+    lambda(static_cast<ElementType&>(*it));
+    return true;
+}
+
+template <typename T, std::size_t NumShards>
+template <typename Lambda>
+bool ConcurrentMap<T, NumShards>::read(std::string_view key, Lambda && lambda) const
+{
+    auto const& shard = shardFor(key);
+    std::shared_lock lock(shard.mutex);
+
+    auto it = shard.map.find(key);
+
+    if (it == shard.map.end())
+        return false;
+
+    lambda(static_cast<ElementType const&>(*it));
+    return true;
+}
+
+template <typename T, std::size_t NumShards>
+bool ConcurrentMap<T, NumShards>::removeElement(std::string_view key)
+{
+    auto& shard = shardFor(key);
+    std::unique_lock lock(shard.mutex);
+    return shard.map.removeElement(key);
+}
+
+template <typename T, std::size_t NumShards>
+bool ConcurrentMap<T, NumShards>::contains(std::string_view key) const
+{
+    auto const& shard = shardFor(key);
+    std::shared_lock lock(shard.mutex);
+    return shard.map.contains(key);
+}
+
+template <typename T, std::size_t NumShards>
+std::size_t ConcurrentMap<T, NumShards>::size() const
+{
+    std::size_t result = 0;
+
+    for (auto const& shard : shards)
+    {
+        std::shared_lock lock(shard.mutex);
+        result += shard.map.size();
+    }
+
+    return result;
+}
+
+template <typename T, std::size_t NumShards>
+MetaType const& ConcurrentMap<T, NumShards>::meta()
+{
+    return metaTypeOf<ConcurrentMap>();
+}
+
+template <typename T, std::size_t NumShards>
+std::vector<std::reference_wrapper<Value const>> ConcurrentMap<T, NumShards>::typeErasedFields() const
+{
+    std::vector<std::reference_wrapper<Value const>> result;
+
+    for (auto const& shard : shards)
+        for (auto const& value : shard.map.fieldRange())
+            result.emplace_back(value);
+
+    return result;
+}
+
+template <typename T, std::size_t NumShards>
+std::vector<std::reference_wrapper<Value>> ConcurrentMap<T, NumShards>::typeErasedFields()
+{
+    std::vector<std::reference_wrapper<Value>> result;
+
+    for (auto& shard : shards)
+        for (auto& value : shard.map.fieldRange())
+            result.emplace_back(value);
+
+    return result;
+}
+
+template <typename T, std::size_t NumShards>
+std::size_t ConcurrentMap<T, NumShards>::fieldCount() const
+{
+    std::size_t result = 0;
+
+    for (auto const& shard : shards)
+        result += shard.map.fieldCount();
+
+    return result;
+}
+
+template <typename T, std::size_t NumShards>
+Value const& ConcurrentMap<T, NumShards>::fieldAt(std::size_t idx) const
+{
+    for (auto const& shard : shards)
+    {
+        auto const n = shard.map.fieldCount();
+
+        if (idx < n)
+            return shard.map.fieldAt(idx);
+
+        idx -= n;
+    }
+
+    return Value::kInvalid;
+}
+
+template <typename T, std::size_t NumShards>
+Value& ConcurrentMap<T, NumShards>::fieldAt(std::size_t idx)
+{
+    return const_cast<Value&>(std::as_const(*this).fieldAt(idx));
+}
+
+template <typename T, std::size_t NumShards>
+bool ConcurrentMap<T, NumShards>::assign(Value const& unsafeOther)
+{
+    if (type() != unsafeOther.type())
+        return false;
+
+    auto const& other = static_cast<ConcurrentMap const&>(unsafeOther);
+
+    for (std::size_t idx = 0; idx < NumShards; ++idx)
+    {
+        std::unique_lock lock(shards[idx].mutex);
+        shards[idx].map.assign(other.shards[idx].map);
+    }
+
+    return true;
+}
+
+template <typename T, std::size_t NumShards>
+std::uint64_t ConcurrentMap<T, NumShards>::contentHash() const
+{
+    return cachedContentHash([this]
+    {
+        auto hash = detail::SchemaHash<ConcurrentMap>::value;
+
+        for (auto const& shard : shards)
+        {
+            std::shared_lock lock(shard.mutex);
+            hash = detail::fnv1a(shard.map.contentHash(), hash);
+        }
+
+        return hash;
+    });
+}
+
+template <typename T, std::size_t NumShards>
+bool ConcurrentMap<T, NumShards>::assignChild(std::string const& name, Value const& newValue)
+{
+    auto& shard = shardFor(name);
+    std::unique_lock lock(shard.mutex);
+    return shard.map.assignChild(name, newValue);
+}
+
+template <typename T, std::size_t NumShards>
+bool ConcurrentMap<T, NumShards>::removeChild(std::string const& name)
+{
+    return removeElement(name);
+}
+
+} // namespace dynamic
@@ -4,6 +4,11 @@
 #include <tuple>
 #include <utility>
 #include <concepts>
+#include <functional>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
 #include "3rdparty/boost/pfr.hpp"
 #include "fixed_string.hpp"
 
@@ -11,12 +16,16 @@ namespace dynamic
 {
 
 // Forward declarations needed by detail namespace
-template <typename T, fixstr::fixed_string Name> class Field;
+struct NoFieldHooks;
+template <typename T, fixstr::fixed_string Name, typename Hooks = NoFieldHooks> class Field;
+template <typename T, fixstr::fixed_string Name, typename Function, fixstr::fixed_string... Dependencies> class Computed;
 template <typename T> class Fundamental;
 template <typename T> class Record;
 template <typename T> class Array;
 template <typename T> class Map;
+template <typename T, std::size_t NumShards = 16> class ConcurrentMap;
 class Value;
+template <typename = void> struct ExtraFundamentalTypes;
 
 //=============================================================================
 // Implementation details - not part of the public API
@@ -63,21 +72,71 @@ struct DoesLambdaSupportType
 //-----------------------------------------------------------------------------
 
 template <typename T> struct is_field_helper : std::false_type {};
-template <typename T, fixstr::fixed_string Name> struct is_field_helper<Field<T, Name>> : std::true_type {};
+template <typename T, fixstr::fixed_string Name, typename Hooks> struct is_field_helper<Field<T, Name, Hooks>> : std::true_type {};
+template <typename T, fixstr::fixed_string Name, typename Function, fixstr::fixed_string... Dependencies>
+struct is_field_helper<Computed<T, Name, Function, Dependencies...>> : std::true_type {};
 
 /// Predicate that is true if T is a Field<> specialization
 template <typename T> struct is_field { static constexpr auto value = is_field_helper<std::decay_t<T>>::value; };
 
+/// Yields U, but only once T is known: defers lookups of non-dependent names into the instantiation context
+template <typename T, typename U>
+struct dependent_type { using type = U; };
+
+template <typename T, typename U>
+using dependent_t = typename dependent_type<T, U>::type;
+
+/// True if the std::tuple of types Tuple contains T
+template <typename T, typename Tuple> struct tuple_contains;
+template <typename T, typename... Ts>
+struct tuple_contains<T, std::tuple<Ts...>> : std::bool_constant<(std::is_same_v<T, Ts> || ...)> {};
+
+/// True if T was registered as a leaf type via ExtraFundamentalTypes
+template <typename T>
+constexpr bool is_extra_fundamental()
+{
+    return tuple_contains<T, typename ExtraFundamentalTypes<dependent_t<T, void>>::Types>::value;
+}
+
 /// Returns the number of Field<> members in struct T
 template <typename T>
 constexpr std::size_t num_fields()
 {
-    if constexpr (std::is_aggregate_v<T>)
+    if constexpr (std::is_aggregate_v<T> && ! is_extra_fundamental<T>())
         return std::tuple_size_v<decltype(filter_tuple<is_field>(boost::pfr::structure_tie(std::declval<T&>())))>;
 
     return 0;
 }
 
+/// Indices (as used by boost::pfr::get) of the Field<> members of aggregate T
+template <typename T>
+constexpr auto field_member_indices()
+{
+    return std::invoke([] <std::size_t... Is> (std::index_sequence<Is...>)
+    {
+        constexpr std::array<bool, sizeof...(Is)> isField = {{ is_field<boost::pfr::tuple_element_t<Is, T>>::value... }};
+
+        std::array<std::size_t, num_fields<T>()> indices = {};
+        std::size_t n = 0;
+
+        for (std::size_t idx = 0; idx < sizeof...(Is); ++idx)
+            if (isField[idx])
+                indices[n++] = idx;
+
+        return indices;
+    }, std::make_index_sequence<boost::pfr::tuple_size_v<T>>());
+}
+
+/// Structural schema hash of T (defined in dynamic.tpp)
+template <typename T> struct SchemaHash;
+
+/// Deep copy of values of type T on a ThreadPool (defined in dynamic_parallel.hpp)
+template <typename T> struct ParallelCopy;
+template <typename Container, typename T> struct ParallelContainerCopy;
+
+/// Computes the changes between two values of type T (defined in dynamic_diff.hpp)
+namespace diff { template <typename T> struct Differ; }
+
 /// Helper to decay all types in a tuple
 template <typename T> struct decay_tuple;
 template <typename... Types> struct decay_tuple<std::tuple<Types...>>
@@ -107,11 +166,7 @@ struct FindFieldHelper
     static constexpr auto&& eval(Field0 && field0, Fields && ...fields)
     {
         // Extract the name from the Field type at compile-time
-        static auto constexpr fieldname = std::invoke(
-            [] <typename T, fixstr::fixed_string Name> (std::type_identity<Field<T, Name>>)
-            { return Name; },
-            std::type_identity<std::remove_cvref_t<Field0>>()
-        );
+        static auto constexpr fieldname = std::remove_cvref_t<Field0>::kFieldName;
 
         // Dispatch based on whether the name matches
         return std::invoke(
@@ -125,7 +180,7 @@ struct FindFieldHelper
                 (std::bool_constant<false>, Field0_ &&        , Fields_ && ...fields_) -> auto&&
                 { return FindFieldHelper::eval(std::forward<Fields_>(fields_)...); }
             ),
-            std::bool_constant<fieldname == FieldName>(),
+            std::bool_constant<fieldname == std::string_view(FieldName)>(),
             std::forward<Field0>(field0),
             std::forward<Fields>(fields)...
         );
@@ -133,16 +188,25 @@ struct FindFieldHelper
 };
 
 template <typename T>
-using BaseTypeFor = std::conditional_t<requires (T t) { [] <typename U> (Array<U>&){}(t); } || requires (T t) { [] <typename U> (Map<U>&){}(t); }, T,
+using BaseTypeFor = std::conditional_t<requires (T t) { [] <typename U> (Array<U>&){}(t); } || requires (T t) { [] <typename U> (Map<U>&){}(t); }
+                                       || requires (T t) { [] <typename U, std::size_t N> (ConcurrentMap<U, N>&){}(t); }, T,
                                        std::conditional_t<num_fields<T>() >= 1, Record<T>, Fundamental<T>>>;
 
 /// Extract the value type T from a Field<T, Name>
 template <typename F> struct field_value_type;
-template <typename T, fixstr::fixed_string Name>
-struct field_value_type<Field<T, Name>> { using type = T; };
+template <typename T, fixstr::fixed_string Name, typename Hooks>
+struct field_value_type<Field<T, Name, Hooks>> { using type = T; };
+template <typename T, fixstr::fixed_string Name, typename Function, fixstr::fixed_string... Dependencies>
+struct field_value_type<Computed<T, Name, Function, Dependencies...>> { using type = T; };
 template <typename F>
 using field_value_type_t = typename field_value_type<F>::type;
 
+/// Decayed parameter types of the call operator of Function (which must not be a template)
+template <typename Function> struct call_arguments : call_arguments<decltype(&Function::operator())> {};
+template <typename R, typename... Args> struct call_arguments<R (*)(Args...)> { using type = std::tuple<std::decay_t<Args>...>; };
+template <typename R, typename C, typename... Args> struct call_arguments<R (C::*)(Args...)> { using type = std::tuple<std::decay_t<Args>...>; };
+template <typename R, typename C, typename... Args> struct call_arguments<R (C::*)(Args...) const> { using type = std::tuple<std::decay_t<Args>...>; };
+
 template<template<typename, typename> class Cls, typename T>
 struct BindFirst
 {
@@ -162,7 +226,7 @@ struct transform_tuple<std::tuple<Ts...>, Transform> {
     using type = std::tuple<typename Transform<Ts>::type...>;
 };
 
-// Helper class to transform a tuple to a variant
+// Helper class to apply the types of a tuple to a variadic template
 template <template<typename...> class Transform, typename Tuple>
 struct apply_tuple;
 
@@ -173,8 +237,118 @@ struct apply_tuple<Transform, std::tuple<Ts...>> {
 
 template <typename T> struct add_lvalue_ref { using type = T&; };
 template <typename T> struct add_const_lvalue_ref { using type = T const&; };
-template <typename T> struct add_reference_wrapper { using type = std::reference_wrapper<T>; };
-template <typename T> struct add_const_reference_wrapper { using type = std::reference_wrapper<T const>; };
+
+/// Position of type T within a std::tuple of types (equals the tuple size if T is not present)
+template <typename T, typename Tuple>
+struct tuple_index;
+
+template <typename T, typename... Ts>
+struct tuple_index<T, std::tuple<Ts...>>
+{
+    static constexpr std::size_t value = std::invoke([]
+    {
+        constexpr std::array<bool, sizeof...(Ts)> matches = {{ std::is_same_v<T, Ts>... }};
+
+        for (std::size_t idx = 0; idx < matches.size(); ++idx)
+            if (matches[idx])
+                return idx;
+
+        return matches.size();
+    });
+};
+
+//-----------------------------------------------------------------------------
+// Decoding leaves from untrusted bytes
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Copies a trivially copyable leaf from bytes which may not hold a valid T
+ *
+ * Not every byte pattern is a valid bool or enum, so a bool is read as a byte
+ * which must be 0 or 1 and an enum through its underlying type. Other types
+ * are copied byte-wise.
+ *
+ * @return False if bytes do not hold a valid T (out is left unchanged)
+ */
+template <typename T>
+bool leaf_from_bytes(std::byte const* bytes, T& out)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        std::uint8_t byte = 0;
+        std::memcpy(&byte, bytes, sizeof(byte));
+
+        if (byte > 1)
+            return false;
+
+        out = byte != 0;
+    }
+    else if constexpr (std::is_enum_v<T>)
+    {
+        std::underlying_type_t<T> underlying;
+        std::memcpy(&underlying, bytes, sizeof(underlying));
+        out = static_cast<T>(underlying);
+    }
+    else
+    {
+        std::memcpy(&out, bytes, sizeof(T));
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Hashing and type names
+//-----------------------------------------------------------------------------
+
+inline constexpr std::uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+
+/// 64-bit FNV-1a hash of str, continuing from seed
+constexpr std::uint64_t fnv1a(std::string_view str, std::uint64_t seed = kFnvOffsetBasis)
+{
+    for (auto c : str)
+    {
+        seed ^= static_cast<unsigned char>(c);
+        seed *= 1099511628211ull;
+    }
+
+    return seed;
+}
+
+/// Feeds the bytes of value into the FNV-1a hash seed
+constexpr std::uint64_t fnv1a(std::uint64_t value, std::uint64_t seed)
+{
+    for (std::size_t i = 0; i < sizeof(value); ++i)
+    {
+        seed ^= (value >> (8 * i)) & 0xffu;
+        seed *= 1099511628211ull;
+    }
+
+    return seed;
+}
+
+/// Compiler generated name of T, e.g. "ns::Point" (not portable across compilers)
+template <typename T>
+constexpr std::string_view type_name()
+{
+   #if defined(_MSC_VER) && ! defined(__clang__)
+    std::string_view const signature = __FUNCSIG__;
+    auto const start = signature.find("type_name<") + 10;
+    auto const end = signature.rfind(">(void)");
+   #else
+    // clang: "... type_name() [T = Point]", gcc: "... type_name() [with T = Point; ...]"
+    std::string_view const signature = __PRETTY_FUNCTION__;
+    auto const start = signature.find("T = ") + 4;
+    auto end = signature.find(';', start);
+
+    if (end == std::string_view::npos)
+        end = signature.rfind(']');
+   #endif
+
+    return signature.substr(start, end - start);
+}
 } // namespace detail
 
 } // namespace dynamic
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+#include "dynamic.hpp"
+
+namespace dynamic
+{
+
+/**
+ * @brief A single change between two values, see diff()
+ *
+ * path is relative to the diffed records. value is the new value for
+ * Operation::add and Operation::modify, and nullptr for Operation::remove.
+ */
+struct Change
+{
+    ID path;
+    Object::Operation operation;
+    std::unique_ptr<Value> value;
+};
+
+/// Whether diff() may skip subtrees whose content hashes are equal
+enum class DiffMode
+{
+    /// Every leaf is compared, the changes are always exact
+    exact,
+
+    /**
+     * Subtrees with equal content hashes (see Value::contentHash()) are skipped
+     * without being visited, which is much faster for large, mostly unchanged
+     * trees. The result is probabilistic: a change whose hash collides with the
+     * hash of the old subtree (a chance of about 2^-64 per subtree) is missed,
+     * and so is a NaN leaf which was replaced by a NaN. Subtrees with leaves
+     * whose hash does not cover their whole value are always visited.
+     */
+    hashed
+};
+
+/**
+ * @brief Returns the changes which turn from into to
+ *
+ * Both trees are walked in lockstep, in DiffMode::hashed skipping subtrees
+ * with equal content hashes. A change is emitted for every leaf that
+ * differs, and for every Array/Map element that was added or removed. Changed
+ * elements that exist in both containers are diffed recursively instead of
+ * being replaced. Array elements are compared by index, Map elements by key.
+ * Within an Array, additions are emitted in ascending and removals in
+ * descending index order, so the changes can be applied one after another
+ * with applyDiff().
+ */
+template <typename T>
+std::vector<Change> diff(Record<T> const& from, Record<T> const& to, DiffMode mode = DiffMode::exact);
+
+/**
+ * @brief Applies changes produced by diff() to target via assignChild()/removeChild()
+ *
+ * Listeners of target are notified for every change.
+ *
+ * @return False if a change could not be applied (the remaining changes are skipped)
+ */
+inline bool applyDiff(Object& target, std::span<Change const> changes)
+{
+    for (auto const& change : changes)
+    {
+        if (change.path.empty())
+            return false;
+
+        auto parentPath = change.path;
+        parentPath.pop_back();
+
+        auto& parent = target.getchild(parentPath);
+
+        if (! parent.isValid() || ! parent.isStruct())
+            return false;
+
+        auto& object = static_cast<Object&>(parent);
+        auto const& name = change.path.back();
+
+        auto const success = change.operation == Object::Operation::remove ? object.removeChild(name)
+                                                                           : change.value != nullptr && object.assignChild(name, *change.value);
+
+        if (! success)
+            return false;
+    }
+
+    return true;
+}
+
+//=============================================================================
+// Implementation details
+//=============================================================================
+namespace detail::diff
+{
+
+/// Diffs two reflection wrappers of T (Fundamental<T>, Record<T> or the container itself)
+template <typename T>
+struct Differ
+{
+    using Wrapper = BaseTypeFor<T>;
+
+    static void run(Wrapper const& from, Wrapper const& to, ID& path, std::vector<Change>& changes, DiffMode mode)
+    {
+        if constexpr (Value::isOpaque<T>())
+        {
+            if (! leaf_equal(from(), to()))
+                changes.push_back({ path, Object::Operation::modify, std::make_unique<Fundamental<T>>(to()) });
+        }
+        else
+        {
+            if constexpr (has_exact_content_hash<T>::value)
+                if (mode == DiffMode::hashed && from.contentHash() == to.contentHash())
+                    return;
+
+            auto const fromFields = from.fields();
+            auto const toFields = to.fields();
+
+            std::invoke([&] <std::size_t... Is> (std::index_sequence<Is...>)
+            {
+                (runField<Is>(std::get<Is>(fromFields), std::get<Is>(toFields), path, changes, mode), ...);
+            }, std::make_index_sequence<Record<T>::kFieldNames.size()>());
+        }
+    }
+
+private:
+    template <std::size_t I, typename F>
+    static void runField(F const& from, F const& to, ID& path, std::vector<Change>& changes, DiffMode mode)
+    {
+        path.emplace_back(Record<T>::kFieldNames[I]);
+        Differ<field_value_type_t<std::remove_cvref_t<F>>>::run(from, to, path, changes, mode);
+        path.pop_back();
+    }
+};
+
+template <typename T>
+struct Differ<Array<T>>
+{
+    using Wrapper = Array<T>;
+    using ElementType = typename Array<T>::ElementType;
+
+    static void run(Wrapper const& from, Wrapper const& to, ID& path, std::vector<Change>& changes, DiffMode mode)
+    {
+        if constexpr (has_exact_content_hash<Array<T>>::value)
+            if (mode == DiffMode::hashed && from.contentHash() == to.contentHash())
+                return;
+
+        auto const fromSize = from.size();
+        auto const toSize = to.size();
+        auto const common = std::min(fromSize, toSize);
+
+        for (std::size_t idx = 0; idx < common; ++idx)
+        {
+            path.push_back(std::to_string(idx));
+            Differ<T>::run(from[idx], to[idx], path, changes, mode);
+            path.pop_back();
+        }
+
+        for (std::size_t idx = common; idx < toSize; ++idx)
+        {
+            path.push_back(std::to_string(idx));
+            changes.push_back({ path, Object::Operation::add, std::make_unique<ElementType>(to[idx]()) });
+            path.pop_back();
+        }
+
+        for (auto idx = fromSize; idx > common; --idx)
+        {
+            path.push_back(std::to_string(idx - 1));
+            changes.push_back({ path, Object::Operation::remove, nullptr });
+            path.pop_back();
+        }
+    }
+};
+
+template <typename T>
+struct Differ<Map<T>>
+{
+    using Wrapper = Map<T>;
+    using ElementType = typename Map<T>::ElementType;
+
+    static void run(Wrapper const& from, Wrapper const& to, ID& path, std::vector<Change>& changes, DiffMode mode)
+    {
+        if constexpr (has_exact_content_hash<Map<T>>::value)
+            if (mode == DiffMode::hashed && from.contentHash() == to.contentHash())
+                return;
+
+        // Maps which were derived from each other usually keep their order: try the
+        // element at the same position before searching for the key
+        auto const lookup = [] (Wrapper const& map, auto positional, std::string const& key) -> ElementType const*
+        {
+            if (positional != map.end() && positional->fieldname() == key)
+                return &*positional;
+
+            auto const it = map.find(std::string_view(key));
+            return it != map.end() ? &*it : nullptr;
+        };
+
+        auto toIt = to.begin();
+
+        for (auto const& fromElement : from)
+        {
+            auto const key = fromElement.fieldname();
+            path.push_back(key);
+
+            if (auto const* toElement = lookup(to, toIt, key))
+                Differ<T>::run(fromElement, *toElement, path, changes, mode);
+            else
+                changes.push_back({ path, Object::Operation::remove, nullptr });
+
+            path.pop_back();
+
+            if (toIt != to.end())
+                ++toIt;
+        }
+
+        auto fromIt = from.begin();
+
+        for (auto const& toElement : to)
+        {
+            auto key = toElement.fieldname();
+
+            if (lookup(from, fromIt, key) == nullptr)
+            {
+                path.push_back(std::move(key));
+                changes.push_back({ path, Object::Operation::add, std::make_unique<ElementType>(toElement()) });
+                path.pop_back();
+            }
+
+            if (fromIt != from.end())
+                ++fromIt;
+        }
+    }
+};
+
+/// Keys are hashed to the same shard in both maps: the shards are diffed like maps
+template <typename T, std::size_t NumShards>
+struct Differ<ConcurrentMap<T, NumShards>>
+{
+    using Wrapper = ConcurrentMap<T, NumShards>;
+
+    static void run(Wrapper const& from, Wrapper const& to, ID& path, std::vector<Change>& changes, DiffMode mode)
+    {
+        if constexpr (has_exact_content_hash<Wrapper>::value)
+            if (mode == DiffMode::hashed && from.contentHash() == to.contentHash())
+                return;
+
+        for (std::size_t idx = 0; idx < NumShards; ++idx)
+            Differ<Map<T>>::run(from.shards[idx].map, to.shards[idx].map, path, changes, mode);
+    }
+};
+
+} // namespace detail::diff
+
+template <typename T>
+std::vector<Change> diff(Record<T> const& from, Record<T> const& to, DiffMode mode)
+{
+    std::vector<Change> changes;
+    ID path;
+    detail::diff::Differ<T>::run(from, to, path, changes, mode);
+    return changes;
+}
+
+} // namespace dynamic
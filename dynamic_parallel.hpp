@@ -0,0 +1,503 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "dynamic.hpp"
+
+namespace dynamic
+{
+
+/**
+ * @brief A work-stealing thread pool for fork/join style parallelism
+ *
+ * Every thread has its own task queue. Tasks spawned by a worker go to the
+ * back of its own queue and are taken from there again (depth first), idle
+ * workers steal from the front of other queues (oldest, usually largest task
+ * first). A thread waiting for a TaskGroup runs queued tasks while it waits,
+ * so task groups can be nested.
+ *
+ * @code
+ * ThreadPool pool(4);
+ * ThreadPool::TaskGroup group(pool);
+ * group.run([] { ... });
+ * group.run([] { ... });
+ * group.wait();
+ * @endcode
+ */
+class ThreadPool
+{
+public:
+    /// Creates a pool in which up to threads threads, including the one waiting for a TaskGroup, execute tasks
+    explicit ThreadPool(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()));
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    /// The number of threads executing tasks (see constructor)
+    std::size_t concurrency() const { return queues.size(); }
+
+    /// A set of tasks which can be waited for
+    class TaskGroup
+    {
+    public:
+        explicit TaskGroup(ThreadPool& pool_) : pool(pool_) {}
+        ~TaskGroup() { wait(); }
+
+        TaskGroup(TaskGroup const&) = delete;
+        TaskGroup& operator=(TaskGroup const&) = delete;
+
+        /// Queues task. Tasks must not throw.
+        void run(std::function<void()> task);
+
+        /// Runs queued tasks until all tasks of this group finished
+        void wait();
+
+    private:
+        friend class ThreadPool;
+
+        ThreadPool& pool;
+        std::atomic<std::size_t> pending = 0;
+    };
+
+private:
+    struct Task
+    {
+        std::function<void()> function;
+        TaskGroup* group;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /// Index of the calling thread's queue: workers own queues 1..n-1, all other threads share queue 0
+    std::size_t queueIndex() const { return currentPool == this ? currentIndex : 0; }
+
+    void push(Task task);
+    bool runOne(std::size_t index);
+    void workerLoop(std::size_t index);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> queued = 0;
+    std::atomic<bool> stopping = false;
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+
+    static inline thread_local ThreadPool const* currentPool = nullptr;
+    static inline thread_local std::size_t currentIndex = 0;
+};
+
+/**
+ * @brief Returns a deep copy of source, copying large containers in parallel on pool
+ *
+ * Equivalent to Record<T>(source), but Arrays and Maps with more than grainSize
+ * elements are split into chunks of grainSize elements which are copied in
+ * parallel, as are the containers nested in their elements. The struct fields
+ * of records with more than grainSize leaves are copied in parallel, too. Parent pointers of
+ * the copy are set up as usual; listeners are not copied and no listener is
+ * called. source must not be modified during the copy.
+ */
+template <typename T>
+Record<T> parallelCopy(Record<T> const& source, ThreadPool& pool, std::size_t grainSize = 1024);
+
+namespace detail { template <typename Lambda> struct LeafVisitor; }
+
+/**
+ * @brief Location of a leaf passed to the lambda of parallelVisitLeaves()
+ *
+ * Refers to the leaf and the visited object; the path in between is only
+ * built when id() is called.
+ */
+class LeafPath
+{
+public:
+    /// Returns the path of the leaf relative to the visited object
+    ID id() const;
+
+private:
+    template <typename> friend struct detail::LeafVisitor;
+
+    LeafPath(Object const& root_, Value const& leaf_) : root(root_), leaf(leaf_) {}
+
+    Object const& root;
+    Value const& leaf;
+};
+
+/**
+ * @brief Calls lambda for every leaf below object, visiting large subtrees in parallel on pool
+ *
+ * Leaves are all values which are not structs: the fundamental fields of records
+ * and the elements of containers with a fundamental element type. lambda is called
+ * as lambda(Value const& leaf) or, if it accepts one, as lambda(Value const& leaf,
+ * LeafPath const& path). It is called concurrently from several threads and in no
+ * particular order.
+ *
+ * Containers are split into chunks of about grainSize leaves, estimated from their
+ * size and the MetaType of their elements, which are visited as separate tasks. The
+ * walk does not allocate per visited node (see Object::fieldAt()). Lazy containers
+ * are loaded when they are reached. object must not be modified during the visit.
+ *
+ * @code
+ * std::atomic<double> total = 0.0;
+ * parallelVisitLeaves(state, [&total] (Value const& leaf)
+ * {
+ *     leaf.visit([&total] (double x) { total += x; });
+ * }, pool);
+ * @endcode
+ */
+template <typename Lambda>
+void parallelVisitLeaves(Object const& object, Lambda && lambda, ThreadPool& pool, std::size_t grainSize = 4096);
+
+//=============================================================================
+// ThreadPool implementations
+//=============================================================================
+inline ThreadPool::ThreadPool(std::size_t threads)
+{
+    threads = std::max(threads, std::size_t(1));
+
+    for (std::size_t idx = 0; idx < threads; ++idx)
+        queues.push_back(std::make_unique<Queue>());
+
+    for (std::size_t idx = 1; idx < threads; ++idx)
+        workers.emplace_back([this, idx] { workerLoop(idx); });
+}
+
+inline ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(sleepMutex);
+        stopping = true;
+    }
+
+    wakeUp.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+inline void ThreadPool::push(Task task)
+{
+    {
+        auto& queue = *queues[queueIndex()];
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    ++queued;
+
+    // taking the mutex orders this wake up after a worker's check of queued
+    { std::lock_guard lock(sleepMutex); }
+    wakeUp.notify_one();
+}
+
+inline bool ThreadPool::runOne(std::size_t index)
+{
+    std::optional<Task> task;
+
+    for (std::size_t offset = 0; offset < queues.size() && ! task; ++offset)
+    {
+        auto& queue = *queues[(index + offset) % queues.size()];
+        std::lock_guard lock(queue.mutex);
+
+        if (queue.tasks.empty())
+            continue;
+
+        // own queue: newest task first, other queues: steal the oldest task
+        if (offset == 0)
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+
+    if (! task)
+        return false;
+
+    --queued;
+    task->function();
+    task->group->pending.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+inline void ThreadPool::workerLoop(std::size_t index)
+{
+    currentPool = this;
+    currentIndex = index;
+
+    while (! stopping)
+    {
+        if (runOne(index))
+            continue;
+
+        std::unique_lock lock(sleepMutex);
+        wakeUp.wait(lock, [this] { return stopping || queued > 0; });
+    }
+}
+
+inline void ThreadPool::TaskGroup::run(std::function<void()> task)
+{
+    pending.fetch_add(1, std::memory_order_relaxed);
+    pool.push({ std::move(task), this });
+}
+
+inline void ThreadPool::TaskGroup::wait()
+{
+    while (pending.load(std::memory_order_acquire) != 0)
+        if (! pool.runOne(pool.queueIndex()))
+            std::this_thread::yield();
+}
+
+inline ID LeafPath::id() const
+{
+    ID result;
+
+    for (Value const* value = &leaf; value != nullptr && value != &root; value = value->parent)
+        if (! value->isStruct() || static_cast<Object const*>(value)->sharedAncestorsMutex == nullptr)
+            result.push_back(value->fieldname());
+
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+//=============================================================================
+// Implementation details
+//=============================================================================
+namespace detail
+{
+
+/// Estimated number of leaves of a value of type meta. Nested containers count as a single leaf.
+inline std::size_t estimatedLeafCount(MetaType const& meta)
+{
+    if (! meta.isRecord())
+        return 1;
+
+    std::size_t count = 0;
+
+    for (auto const& field : meta.fields())
+        count += estimatedLeafCount(field.metaType());
+
+    return std::max(count, std::size_t(1));
+}
+
+/**
+ * @brief Copies a value into a default constructed value of the same type
+ *
+ * Writes the underlying values directly: nothing is notified and no version
+ * is stamped, as for a copy constructor. Operates on the reflection wrapper of
+ * T (Fundamental<T>, Record<T> or the container itself).
+ */
+template <typename T>
+struct ParallelCopy
+{
+    using Wrapper = BaseTypeFor<T>;
+
+    static void run(Wrapper& destination, Wrapper const& source, ThreadPool::TaskGroup& group, std::size_t grainSize)
+    {
+        if constexpr (Value::isOpaque<T>())
+        {
+            destination.underlying = source.underlying;
+        }
+        else
+        {
+            // the fields of a record are independent: large records copy their struct fields in separate tasks
+            static auto const kLeafCount = estimatedLeafCount(metaTypeOf<T>());
+            auto const split = kLeafCount > grainSize;
+
+            // all members, including those which are not a Field<>
+            std::invoke([&] <std::size_t... Is> (std::index_sequence<Is...>)
+            {
+                (runMember(boost::pfr::get<Is>(destination.underlying), boost::pfr::get<Is>(source.underlying), group, grainSize, split), ...);
+            }, std::make_index_sequence<boost::pfr::tuple_size_v<T>>());
+        }
+    }
+
+private:
+    template <typename M>
+    static void runMember(M& destination, M const& source, ThreadPool::TaskGroup& group, std::size_t grainSize, bool split)
+    {
+        if constexpr (is_field<M>::value)
+        {
+            using FieldValueType = field_value_type_t<M>;
+
+            if constexpr (! Value::isOpaque<FieldValueType>())
+            {
+                if (split)
+                {
+                    group.run([&destination, &source, &group, grainSize] { ParallelCopy<FieldValueType>::run(destination, source, group, grainSize); });
+                    return;
+                }
+            }
+
+            ParallelCopy<FieldValueType>::run(destination, source, group, grainSize);
+        }
+        else
+        {
+            destination = source;
+        }
+    }
+};
+
+/// Copies the elements of Array and Map containers, see ParallelCopy
+template <typename Container, typename T>
+struct ParallelContainerCopy
+{
+    static void run(Container& destination, Container const& source, ThreadPool::TaskGroup& group, std::size_t grainSize)
+    {
+        // default member initializers may have added elements to the destination
+        destination.elements.clear();
+        destination.lazySource = nullptr;
+        destination.lazyPending = false;
+
+        // an unmodified lazy container is copied by sharing its source, as in the copy constructor
+        if (source.lazySource != nullptr && ! source.lazyModified)
+        {
+            destination.lazySource = source.lazySource;
+            destination.lazyPending = true;
+            return;
+        }
+
+        auto const& sourceElements = source.elements;
+        auto const n = sourceElements.size();
+
+        {
+            // constructing default elements is cheap compared to copying them: do it serially
+            MemoryResourceScope scope(destination.resource());
+            destination.elements.reserve(n);
+
+            for (auto const& element : sourceElements)
+            {
+                if constexpr (std::is_same_v<Container, Map<T>>)
+                    destination.elements.emplace_back(element.key, destination);
+                else
+                    destination.elements.emplace_back(destination);
+            }
+        }
+
+        auto const copyRange = [&destination, &sourceElements, &group, grainSize] (std::size_t begin, std::size_t end)
+        {
+            for (auto idx = begin; idx < end; ++idx)
+                ParallelCopy<T>::run(destination.elements[idx], sourceElements[idx], group, grainSize);
+        };
+
+        if (n <= grainSize)
+        {
+            copyRange(0, n);
+            return;
+        }
+
+        for (std::size_t begin = 0; begin < n; begin += grainSize)
+            group.run([copyRange, begin, end = std::min(n, begin + grainSize)] { copyRange(begin, end); });
+    }
+};
+
+template <typename T>
+struct ParallelCopy<Array<T>> : ParallelContainerCopy<Array<T>, T> {};
+
+template <typename T>
+struct ParallelCopy<Map<T>> : ParallelContainerCopy<Map<T>, T> {};
+
+/// Copies the shards of a ConcurrentMap one after the other, each like a Map<T>
+template <typename T, std::size_t NumShards>
+struct ParallelCopy<ConcurrentMap<T, NumShards>>
+{
+    static void run(ConcurrentMap<T, NumShards>& destination, ConcurrentMap<T, NumShards> const& source,
+                    ThreadPool::TaskGroup& group, std::size_t grainSize)
+    {
+        for (std::size_t idx = 0; idx < NumShards; ++idx)
+            ParallelCopy<Map<T>>::run(destination.shards[idx].map, source.shards[idx].map, group, grainSize);
+    }
+};
+
+/// The walk of parallelVisitLeaves()
+template <typename Lambda>
+struct LeafVisitor
+{
+    Object const& root;
+    Lambda& lambda;
+    ThreadPool::TaskGroup& group;
+    std::size_t grainSize;
+
+    void visit(Object const& object) const
+    {
+        // constructs the elements of lazy containers before they are shared between tasks
+        auto const n = object.fieldCount();
+
+        if (object.isMapOrArray() && n > 1)
+        {
+            auto const* elementMeta = object.metaType().elementMetaType();
+            auto const leavesPerElement = elementMeta != nullptr ? estimatedLeafCount(*elementMeta) : 1;
+
+            if (n * leavesPerElement > grainSize)
+            {
+                auto const chunkSize = std::max(grainSize / leavesPerElement, std::size_t(1));
+
+                for (std::size_t begin = 0; begin < n; begin += chunkSize)
+                    group.run([this, &object, begin, end = std::min(n, begin + chunkSize)] { visitRange(object, begin, end); });
+
+                return;
+            }
+        }
+
+        visitRange(object, 0, n);
+    }
+
+    void visitRange(Object const& object, std::size_t begin, std::size_t end) const
+    {
+        for (auto idx = begin; idx < end; ++idx)
+        {
+            auto const& child = object.fieldAt(idx);
+
+            if (child.isStruct())
+                visit(static_cast<Object const&>(child));
+            else if constexpr (std::is_invocable_v<Lambda&, Value const&, LeafPath const&>)
+                lambda(child, LeafPath(root, child));
+            else
+                lambda(child);
+        }
+    }
+};
+
+} // namespace detail
+
+template <typename T>
+Record<T> parallelCopy(Record<T> const& source, ThreadPool& pool, std::size_t grainSize)
+{
+    Record<T> result;
+
+    {
+        ThreadPool::TaskGroup group(pool);
+        detail::ParallelCopy<T>::run(result, source, group, std::max(grainSize, std::size_t(1)));
+        group.wait();
+    }
+
+    return result;
+}
+
+template <typename Lambda>
+void parallelVisitLeaves(Object const& object, Lambda && lambda, ThreadPool& pool, std::size_t grainSize)
+{
+    ThreadPool::TaskGroup group(pool);
+    detail::LeafVisitor<std::remove_reference_t<Lambda>> const visitor { object, lambda, group, std::max(grainSize, std::size_t(1)) };
+
+    visitor.visit(object);
+    group.wait();
+}
+
+} // namespace dynamic
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <typeinfo>
+#include <vector>
+#include "dynamic.hpp"
+
+namespace dynamic
+{
+
+/**
+ * @brief A change captured by an EventRing
+ *
+ * The path is interned: EventRing::path() returns it. Leaf values which are
+ * trivially copyable and at most kInlineSize bytes large are copied into the
+ * event (see value()). Other values, and the values of removals, are not
+ * captured.
+ */
+struct RingEvent
+{
+    static constexpr std::size_t kInlineSize = 16;
+
+    std::uint32_t path = 0;
+    Object::Operation operation = Object::Operation::modify;
+
+    /// Type of the captured value (nullptr if no value was captured)
+    std::type_info const* type = nullptr;
+
+    alignas(std::max_align_t) std::array<std::byte, kInlineSize> bytes = {};
+
+    /// Returns the captured value if it is of type T
+    template <typename T>
+    std::optional<T> value() const requires std::is_trivially_copyable_v<T> && (sizeof(T) <= kInlineSize)
+    {
+        if (type == nullptr || *type != typeid(T))
+            return std::nullopt;
+
+        std::array<std::byte, sizeof(T)> raw;
+        std::memcpy(raw.data(), bytes.data(), sizeof(T));
+        return std::bit_cast<T>(raw);
+    }
+};
+
+/**
+ * @brief Bounded lock-free queue delivering the changes of a tree to another thread
+ *
+ * EventRing registers a path-free child listener (see
+ * Object::addPathFreeChildListener()) on an object and copies every change
+ * into a pre-allocated slot, without locking. Only the first change of a path
+ * allocates, to intern it; no ID is built for later changes. Any number of
+ * threads may change the tree (e.g. the shards of a ConcurrentMap), while a
+ * single consumer thread takes the changes out in batches with drain():
+ *
+ * @code
+ * EventRing ring(state, 4096);
+ *
+ * // UI thread, e.g. on a timer
+ * ring.drain([&] (RingEvent const& event)
+ * {
+ *     if (auto const price = event.value<double>())
+ *         showPrice(ring.path(event.path), *price);
+ * });
+ * @endcode
+ *
+ * Paths are interned in a table holding up to maxPaths entries, keyed by the
+ * address of the object holding the changed value and the value's name: a new
+ * path is built once, the changes of a known path compare it with the names of
+ * the value's ancestors. A value whose ancestor moved in memory (e.g. in a
+ * growing Array) is interned again, so one path may have several indices. If
+ * the ring or the path table is full, the change is dropped and counted (see
+ * dropped()).
+ *
+ * The ring must outlive all changes of the observed tree which may still be in
+ * flight on other threads when it is destroyed.
+ */
+class EventRing
+{
+public:
+    /// Captures the changes of object. capacity is rounded up to a power of two.
+    EventRing(Object& object, std::size_t capacity, std::size_t maxPaths = 1024);
+
+    EventRing(EventRing const&) = delete;
+    EventRing& operator=(EventRing const&) = delete;
+
+    /**
+     * @brief Calls lambda(RingEvent const&) for the oldest buffered events, in order
+     *
+     * Must only be called by one thread at a time.
+     *
+     * @return The number of events passed to lambda (at most maxEvents)
+     */
+    template <std::invocable<RingEvent const&> Lambda>
+    std::size_t drain(Lambda && lambda, std::size_t maxEvents = std::numeric_limits<std::size_t>::max());
+
+    /// Returns the path of an event (interned paths stay valid for the lifetime of the ring)
+    ID const& path(std::uint32_t index) const;
+
+    std::size_t capacity() const { return mask + 1; }
+
+    /// Number of changes which were dropped because the ring or the path table was full
+    std::size_t dropped() const { return numDropped.load(std::memory_order_relaxed); }
+
+    /// Largest number of events which were buffered at once
+    std::size_t highWaterMark() const { return highWater.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        // == position: free for the producer at position, == position + 1: holds the event of position
+        std::atomic<std::size_t> sequence;
+        RingEvent event;
+    };
+
+    /// Open addressing hash table of paths, only ever grows
+    struct PathSlot
+    {
+        std::atomic<std::uint64_t> hash = 0;
+        std::atomic<ID const*> id = nullptr;
+
+        // written before id is published
+        Object const* parentOfValue = nullptr;
+    };
+
+    void push(Object const& parentOfValue, std::string_view name, Object::Operation op, Value const& value);
+    std::optional<std::uint32_t> intern(Object const& parentOfValue, std::string_view name);
+    static std::uint64_t hashOf(Object const& parentOfValue, std::string_view name);
+
+    Object const& object;
+
+    std::size_t mask;
+    std::unique_ptr<Slot[]> slots;
+
+    std::size_t pathMask;
+    std::unique_ptr<PathSlot[]> pathSlots;
+    std::vector<std::unique_ptr<ID>> pathStorage;
+
+    // producers and the consumer write different cache lines
+    alignas(64) std::atomic<std::size_t> tail = 0;
+    alignas(64) std::atomic<std::size_t> head = 0;
+    alignas(64) std::atomic<std::size_t> numDropped = 0;
+    std::atomic<std::size_t> highWater = 0;
+
+    ListenerToken token;
+};
+
+//=============================================================================
+// Implementation
+//=============================================================================
+inline EventRing::EventRing(Object& object_, std::size_t capacity_, std::size_t maxPaths)
+    : object(object_),
+      mask(std::bit_ceil(std::max<std::size_t>(capacity_, 2)) - 1),
+      slots(std::make_unique<Slot[]>(mask + 1)),
+      pathMask(std::bit_ceil(std::max<std::size_t>(maxPaths, 2)) - 1),
+      pathSlots(std::make_unique<PathSlot[]>(pathMask + 1)),
+      pathStorage(pathMask + 1)
+{
+    for (std::size_t i = 0; i <= mask; ++i)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+
+    token = object_.addPathFreeChildListener([this] (Object const& parentOfValue, std::string_view name, Object::Operation op, Value const& value)
+    {
+        push(parentOfValue, name, op, value);
+    });
+}
+
+inline std::uint64_t EventRing::hashOf(Object const& parentOfValue, std::string_view name)
+{
+    std::uint64_t h = 0xcbf29ce484222325ull;
+
+    h = (h ^ std::hash<Object const*>()(&parentOfValue)) * 0x100000001b3ull;
+    h = (h ^ std::hash<std::string_view>()(name)) * 0x100000001b3ull;
+
+    // 0 marks free slots of the path table
+    return h != 0 ? h : 1;
+}
+
+inline std::optional<std::uint32_t> EventRing::intern(Object const& parentOfValue, std::string_view name)
+{
+    auto const h = hashOf(parentOfValue, name);
+
+    for (std::size_t probe = 0; probe <= pathMask; ++probe)
+    {
+        auto const idx = (h + probe) & pathMask;
+        auto& slot = pathSlots[idx];
+        auto current = slot.hash.load(std::memory_order_acquire);
+
+        if (current == 0 && slot.hash.compare_exchange_strong(current, h, std::memory_order_acq_rel))
+        {
+            // the slot is ours: only this thread writes pathStorage[idx]. The only allocation of a path.
+            pathStorage[idx] = std::make_unique<ID>(object.pathTo(parentOfValue, name));
+            slot.parentOfValue = &parentOfValue;
+            slot.id.store(pathStorage[idx].get(), std::memory_order_release);
+            return static_cast<std::uint32_t>(idx);
+        }
+
+        if (current != h)
+            continue;
+
+        // another thread claimed the slot for a path with the same hash: wait until it published the path
+        ID const* stored;
+
+        while ((stored = slot.id.load(std::memory_order_acquire)) == nullptr) {}
+
+        // the object may have moved since, and another one may live at its address now
+        if (slot.parentOfValue == &parentOfValue && object.isPathTo(*stored, parentOfValue, name))
+            return static_cast<std::uint32_t>(idx);
+    }
+
+    return std::nullopt;
+}
+
+inline void EventRing::push(Object const& parentOfValue, std::string_view name, Object::Operation op, Value const& value)
+{
+    auto const pathIndex = intern(parentOfValue, name);
+
+    if (! pathIndex)
+    {
+        numDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto pos = tail.load(std::memory_order_relaxed);
+    Slot* slot;
+
+    for (;;)
+    {
+        slot = &slots[pos & mask];
+        auto const sequence = slot->sequence.load(std::memory_order_acquire);
+        auto const diff = static_cast<std::ptrdiff_t>(sequence - pos);
+
+        if (diff == 0)
+        {
+            if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // the consumer has not freed this slot yet: the ring is full
+            numDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            pos = tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    auto& event = slot->event;
+    event.path = *pathIndex;
+    event.operation = op;
+    event.type = nullptr;
+
+    if (op != Object::Operation::remove)
+    {
+        value.visit([&event] (auto const& v)
+        {
+            using V = std::remove_cvref_t<decltype(v)>;
+
+            if constexpr (std::is_trivially_copyable_v<V> && sizeof(V) <= RingEvent::kInlineSize)
+            {
+                std::memcpy(event.bytes.data(), &v, sizeof(V));
+                event.type = &typeid(V);
+            }
+        });
+    }
+
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    // with several producers, the consumer may already have passed pos + 1
+    auto const consumed = head.load(std::memory_order_relaxed);
+    auto const produced = tail.load(std::memory_order_relaxed);
+    auto const occupancy = produced > consumed ? std::min(produced - consumed, capacity()) : std::size_t(0);
+    auto highest = highWater.load(std::memory_order_relaxed);
+
+    while (occupancy > highest && ! highWater.compare_exchange_weak(highest, occupancy, std::memory_order_relaxed)) {}
+}
+
+template <std::invocable<RingEvent const&> Lambda>
+std::size_t EventRing::drain(Lambda && lambda, std::size_t maxEvents)
+{
+    auto pos = head.load(std::memory_order_relaxed);
+    std::size_t n = 0;
+
+    for (; n < maxEvents; ++n, ++pos)
+    {
+        auto& slot = slots[pos & mask];
+
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+            break;
+
+        lambda(static_cast<RingEvent const&>(slot.event));
+
+        // hand the slot to the producer of the next lap
+        slot.sequence.store(pos + mask + 1, std::memory_order_release);
+        head.store(pos + 1, std::memory_order_relaxed);
+    }
+
+    return n;
+}
+
+inline ID const& EventRing::path(std::uint32_t index) const
+{
+    assert(index <= pathMask);
+    auto const* id = pathSlots[index].id.load(std::memory_order_acquire);
+    assert(id != nullptr);
+    return *id;
+}
+
+} // namespace dynamic
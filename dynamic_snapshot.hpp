@@ -0,0 +1,699 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "dynamic.hpp"
+
+#if __has_include(<sys/mman.h>)
+ #define DYNAMIC_SNAPSHOT_MMAP 1
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#else
+ #define DYNAMIC_SNAPSHOT_MMAP 0
+#endif
+
+namespace dynamic
+{
+
+/**
+ * @brief Header at the start of every snapshot
+ *
+ * A snapshot is a tree of nodes addressed by absolute byte offsets from the
+ * start of the snapshot, so it can be used in place from a memory mapped file.
+ * Every node starts at an offset aligned to 8 bytes:
+ *   - leaves are stored as their raw bytes, std::string as a 64-bit length followed by the characters,
+ *     ID as a 64-bit count followed by the offsets of its (string) elements
+ *   - records are a table of the offsets of their fields, in field order
+ *   - arrays are a 64-bit count followed by the offsets of their elements
+ *   - maps are a 64-bit count followed by pairs of offsets of each key (a string) and value
+ *
+ * Values are stored in native byte order.
+ */
+struct SnapshotHeader
+{
+    static constexpr std::uint32_t kMagic = 0x5359'4e44; // "DNYS" in little-endian byte order
+    static constexpr std::uint16_t kVersion = 1;
+
+    std::uint32_t magic = kMagic;
+    std::uint16_t version = kVersion;
+    std::uint16_t reserved = 0;
+    std::uint64_t schemaHash = 0;
+    std::uint64_t rootOffset = 0;
+    std::uint64_t size = 0;
+};
+
+static_assert(sizeof(SnapshotHeader) == 32 && std::is_trivially_copyable_v<SnapshotHeader>);
+
+/// Serializes record into a snapshot. Leaf types other than std::string and ID must be trivially copyable.
+template <typename T>
+std::vector<std::byte> writeSnapshot(Record<T> const& record);
+
+/// Serializes record into a snapshot file, returns false if the file could not be written
+template <typename T>
+bool writeSnapshot(Record<T> const& record, std::filesystem::path const& path);
+
+/**
+ * @brief Read-only view of a value of type T inside a snapshot
+ *
+ * Views do not copy anything: leaves are read on access and strings are returned
+ * as std::string_view into the snapshot's memory. Use materialize() to create a
+ * regular value from the view or any sub-view (e.g. a single Array of a large
+ * record). The snapshot's memory must outlive the view.
+ *
+ * Offsets pointing outside of the snapshot, and bool leaves other than 0 or 1,
+ * read as empty or default values.
+ *
+ * @code
+ * MappedFile file("state.snapshot");
+ * if (auto state = openSnapshot<State>(file.bytes()))
+ * {
+ *     auto points = (*state)("points"_fld);
+ *     std::cout << points.size() << std::endl;           // no element is touched
+ *     Array<Point> copy = points.materialize();         // load just this subtree
+ * }
+ * @endcode
+ */
+template <typename T>
+class SnapshotView;
+
+/// Returns a view of the root record of snapshot, or nullopt if it's not a valid snapshot of Record<T>
+template <typename T>
+std::optional<SnapshotView<T>> openSnapshot(std::span<std::byte const> snapshot);
+
+/// How loadSnapshot() constructs Arrays and Maps
+enum class SnapshotLoading
+{
+    eager,  ///< construct all elements while loading, listeners of record are notified once
+    lazy    ///< construct elements on first access (see LazyElementSource), listeners of each leaf are notified
+};
+
+/**
+ * @brief Loads a snapshot into record
+ *
+ * With SnapshotLoading::lazy, the Arrays and Maps of record keep referring to
+ * the snapshot's memory, which must then outlive them (and their copies).
+ *
+ * @return False if snapshot is not a valid snapshot of Record<T>
+ */
+template <typename T>
+bool loadSnapshot(std::span<std::byte const> snapshot, Record<T>& record, SnapshotLoading loading = SnapshotLoading::eager);
+
+/**
+ * @brief Read-only memory mapping of a file
+ *
+ * Falls back to reading the whole file into memory on platforms without mmap.
+ */
+class MappedFile
+{
+public:
+    explicit MappedFile(std::filesystem::path const& path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& o) noexcept;
+    MappedFile& operator=(MappedFile&& o) noexcept;
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    /// Returns false if the file could not be opened
+    bool isValid() const { return data != nullptr || fallback.has_value(); }
+
+    std::span<std::byte const> bytes() const
+    {
+        if (fallback)
+            return *fallback;
+
+        return { static_cast<std::byte const*>(data), size };
+    }
+
+private:
+    void unmap();
+
+    void* data = nullptr;
+    std::size_t size = 0;
+    std::optional<std::vector<std::byte>> fallback;
+};
+
+//=============================================================================
+// Implementation details
+//=============================================================================
+namespace detail::snapshot
+{
+
+inline constexpr std::size_t kNodeAlignment = 8;
+
+template <typename T> struct is_array : std::false_type {};
+template <typename T> struct is_array<Array<T>> : std::true_type {};
+
+template <typename T> struct is_map : std::false_type {};
+template <typename T> struct is_map<Map<T>> : std::true_type {};
+
+/// Element type of an Array or Map (void for other types)
+template <typename T> struct element_type { using type = void; };
+template <typename T> struct element_type<Array<T>> { using type = T; };
+template <typename T> struct element_type<Map<T>> { using type = T; };
+
+/// The reflection wrapper of T (Fundamental<T>, Record<T> or the container itself)
+template <typename T> struct wrapper { using type = BaseTypeFor<T>; };
+
+template <typename T>
+constexpr bool is_record_v = ! is_array<T>::value && ! is_map<T>::value && ! Value::isOpaque<T>();
+
+template <typename T>
+constexpr bool is_leaf_v = ! is_array<T>::value && ! is_map<T>::value && Value::isOpaque<T>();
+
+class Writer
+{
+public:
+    Writer() { buffer.resize(sizeof(SnapshotHeader)); }
+
+    std::uint64_t bytes(void const* data, std::size_t size, std::size_t alignment = kNodeAlignment)
+    {
+        auto const offset = (buffer.size() + alignment - 1) / alignment * alignment;
+        buffer.resize(offset + size);
+
+        if (size > 0)
+            std::memcpy(buffer.data() + offset, data, size);
+
+        return offset;
+    }
+
+    template <typename T>
+    std::uint64_t raw(T const& value) { return bytes(&value, sizeof(T), std::max(alignof(T), kNodeAlignment)); }
+
+    std::uint64_t string(std::string_view str)
+    {
+        auto const offset = raw(static_cast<std::uint64_t>(str.size()));
+        bytes(str.data(), str.size(), 1);
+        return offset;
+    }
+
+    /// Writes a table of offsets, optionally prefixed with the number of entries
+    std::uint64_t table(std::span<std::uint64_t const> offsets, std::optional<std::uint64_t> count)
+    {
+        auto const offset = count ? raw(*count) : bytes(nullptr, 0);
+        bytes(offsets.data(), offsets.size_bytes(), 1);
+        return offset;
+    }
+
+    std::vector<std::byte> buffer;
+};
+
+/// Returns the offset of the newly written node for value
+template <typename T>
+std::uint64_t writeNode(Writer& writer, typename wrapper<T>::type const& value)
+{
+    if constexpr (is_array<T>::value || is_map<T>::value)
+    {
+        using ElementValueType = typename element_type<T>::type;
+
+        std::vector<std::uint64_t> offsets;
+        offsets.reserve(value.size() * (is_map<T>::value ? 2 : 1));
+
+        for (auto const& element : value)
+        {
+            if constexpr (is_map<T>::value)
+                offsets.push_back(writer.string(element.fieldname()));
+
+            offsets.push_back(writeNode<ElementValueType>(writer, element));
+        }
+
+        return writer.table(offsets, value.size());
+    }
+    else if constexpr (is_record_v<T>)
+    {
+        return std::apply([&writer] (auto const&... fields)
+        {
+            std::array<std::uint64_t, sizeof...(fields)> const offsets = {{
+                writeNode<field_value_type_t<std::remove_cvref_t<decltype(fields)>>>(writer, fields)...
+            }};
+
+            return writer.table(offsets, std::nullopt);
+        }, value.fields());
+    }
+    else if constexpr (std::is_same_v<T, std::string>)
+    {
+        return writer.string(value());
+    }
+    else if constexpr (std::is_same_v<T, ID>)
+    {
+        std::vector<std::uint64_t> offsets;
+
+        for (auto const& element : value())
+            offsets.push_back(writer.string(element));
+
+        return writer.table(offsets, offsets.size());
+    }
+    else
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Leaf types must be trivially copyable to be stored in a snapshot");
+        return writer.raw(value());
+    }
+}
+
+} // namespace detail::snapshot
+
+template <typename T>
+class SnapshotView
+{
+    using ElementValueType = typename detail::snapshot::element_type<T>::type;
+
+public:
+    SnapshotView() = default;
+    SnapshotView(std::span<std::byte const> snapshot_, std::uint64_t offset_) : snapshot(snapshot_), offset(offset_) {}
+
+    /// Returns false for default constructed views and views of nodes outside of the snapshot
+    bool isValid() const { return offset >= sizeof(SnapshotHeader) && offset < snapshot.size(); }
+
+    //=============================================================================
+    // Leaves
+    //=============================================================================
+
+    /// Returns the leaf value. Strings are returned as a std::string_view into the snapshot.
+    auto get() const requires detail::snapshot::is_leaf_v<T>
+    {
+        if constexpr (std::is_same_v<T, std::string>)
+            return stringAt(offset);
+        else if constexpr (std::is_same_v<T, ID>)
+            return materialize();
+        else
+            return read<T>(offset);
+    }
+
+    //=============================================================================
+    // Records
+    //=============================================================================
+
+    /// Returns a view of the I-th field
+    template <std::size_t I>
+    auto field() const requires detail::snapshot::is_record_v<T>
+    {
+        using FieldType = std::tuple_element_t<I, typename Record<T>::FieldsAsTuple>;
+        return SnapshotView<detail::field_value_type_t<FieldType>>(snapshot, read<std::uint64_t>(offset + I * sizeof(std::uint64_t)));
+    }
+
+    /// Returns a view of the field with the compile-time name FieldName
+    template <fixstr::fixed_string FieldName>
+    auto operator()(CompileTimeString<FieldName>) const requires detail::snapshot::is_record_v<T>
+    {
+        static constexpr auto kIndex = static_cast<std::size_t>(
+            std::ranges::find(Record<T>::kFieldNames, std::string_view(FieldName)) - Record<T>::kFieldNames.begin());
+        static_assert(kIndex < Record<T>::kFieldNames.size(), "No field with this name");
+
+        return field<kIndex>();
+    }
+
+    //=============================================================================
+    // Arrays and maps
+    //=============================================================================
+
+    /// Returns the number of elements
+    std::size_t size() const requires (detail::snapshot::is_array<T>::value || detail::snapshot::is_map<T>::value)
+    {
+        return entryCount(detail::snapshot::is_map<T>::value ? 2 : 1);
+    }
+
+    /// Returns a view of the idx-th element of an array
+    auto operator[](std::size_t idx) const requires detail::snapshot::is_array<T>::value
+    {
+        return SnapshotView<ElementValueType>(snapshot, read<std::uint64_t>(entry(idx)));
+    }
+
+    /// Returns the idx-th key of a map
+    std::string_view keyAt(std::size_t idx) const requires detail::snapshot::is_map<T>::value
+    {
+        return stringAt(read<std::uint64_t>(entry(2 * idx)));
+    }
+
+    /// Returns a view of the idx-th value of a map
+    auto valueAt(std::size_t idx) const requires detail::snapshot::is_map<T>::value
+    {
+        return SnapshotView<ElementValueType>(snapshot, read<std::uint64_t>(entry(2 * idx + 1)));
+    }
+
+    /// Returns a view of the value with the given key, or nullopt (linear search)
+    auto find(std::string_view key) const -> std::optional<SnapshotView<ElementValueType>>
+        requires detail::snapshot::is_map<T>::value
+    {
+        for (std::size_t idx = 0, n = size(); idx < n; ++idx)
+            if (keyAt(idx) == key)
+                return valueAt(idx);
+
+        return std::nullopt;
+    }
+
+    //=============================================================================
+    // Materialization
+    //=============================================================================
+
+    /// Creates a regular value (T, std::string, Array<U>, Map<U>, ...) from this node and all its children
+    T materialize() const;
+
+    /// Like materialize(), but all Arrays and Maps load their elements from the snapshot on first access
+    T materializeLazy() const;
+
+    /// Assigns this node to target (a field or reflection wrapper of T), lazily or not
+    template <typename Target>
+    void assignTo(Target& target, SnapshotLoading loading) const;
+
+private:
+    template <typename U> friend class SnapshotView;
+
+    template <typename U>
+    U read(std::uint64_t at) const
+    {
+        U result{};
+
+        // the file may be corrupt: invalid bools and enums read as default values, too
+        if (at <= snapshot.size() && sizeof(U) <= snapshot.size() - at)
+            detail::leaf_from_bytes(snapshot.data() + at, result);
+
+        return result;
+    }
+
+    std::string_view stringAt(std::uint64_t at) const
+    {
+        auto const length = read<std::uint64_t>(at);
+        auto const start = at + sizeof(std::uint64_t);
+
+        if (start > snapshot.size() || length > snapshot.size() - start)
+            return {};
+
+        return { reinterpret_cast<char const*>(snapshot.data() + start), static_cast<std::size_t>(length) };
+    }
+
+    /// Returns the count of a container or ID, or zero if its offset table doesn't fit into the snapshot (a corrupt snapshot)
+    std::size_t entryCount(std::size_t entriesPerElement) const
+    {
+        if (offset > snapshot.size() || snapshot.size() - offset < sizeof(std::uint64_t))
+            return 0;
+
+        auto const count = read<std::uint64_t>(offset);
+        auto const maxCount = (snapshot.size() - offset - sizeof(std::uint64_t)) / (entriesPerElement * sizeof(std::uint64_t));
+
+        return count <= maxCount ? static_cast<std::size_t>(count) : 0;
+    }
+
+    /// Offset of the idx-th entry of a container's offset table
+    std::uint64_t entry(std::size_t idx) const { return offset + (1 + idx) * sizeof(std::uint64_t); }
+
+    std::span<std::byte const> snapshot;
+    std::uint64_t offset = 0;
+};
+
+template <typename T>
+T SnapshotView<T>::materialize() const
+{
+    if constexpr (detail::snapshot::is_array<T>::value)
+    {
+        T result;
+
+        for (std::size_t idx = 0, n = size(); idx < n; ++idx)
+            result.addElement((*this)[idx].materialize());
+
+        return result;
+    }
+    else if constexpr (detail::snapshot::is_map<T>::value)
+    {
+        T result;
+
+        for (std::size_t idx = 0, n = size(); idx < n; ++idx)
+            result.addElement(keyAt(idx), valueAt(idx).materialize());
+
+        return result;
+    }
+    else if constexpr (detail::snapshot::is_record_v<T>)
+    {
+        T result;
+
+        std::invoke([&] <std::size_t... Is> (std::index_sequence<Is...>)
+        {
+            static constexpr auto kMemberIndices = detail::field_member_indices<T>();
+            ((boost::pfr::get<kMemberIndices[Is]>(result) = field<Is>().materialize()), ...);
+        }, std::make_index_sequence<Record<T>::kFieldNames.size()>());
+
+        return result;
+    }
+    else if constexpr (std::is_same_v<T, std::string>)
+    {
+        return std::string(stringAt(offset));
+    }
+    else if constexpr (std::is_same_v<T, ID>)
+    {
+        ID result;
+
+        for (std::size_t idx = 0, count = entryCount(1); idx < count; ++idx)
+            result.push_back(std::string(stringAt(read<std::uint64_t>(entry(idx)))));
+
+        return result;
+    }
+    else
+    {
+        return read<T>(offset);
+    }
+}
+
+namespace detail::snapshot
+{
+/// Loads the elements of a lazy Array or Map from a snapshot
+template <typename Container>
+class ElementSource final : public LazyElementSource<typename element_type<Container>::type>
+{
+public:
+    using ElementValueType = typename element_type<Container>::type;
+
+    explicit ElementSource(SnapshotView<Container> view_) : view(view_) {}
+
+    std::size_t size() const override { return view.size(); }
+
+    ElementValueType element(std::size_t idx) const override
+    {
+        if constexpr (is_map<Container>::value)
+            return view.valueAt(idx).materializeLazy();
+        else
+            return view[idx].materializeLazy();
+    }
+
+    std::string_view key(std::size_t idx) const override
+    {
+        if constexpr (is_map<Container>::value)
+            return view.keyAt(idx);
+        else
+            return {};
+    }
+
+private:
+    SnapshotView<Container> view;
+};
+} // namespace detail::snapshot
+
+template <typename T>
+T SnapshotView<T>::materializeLazy() const
+{
+    if constexpr (detail::snapshot::is_array<T>::value || detail::snapshot::is_map<T>::value)
+    {
+        T result;
+        result.setLazySource(std::make_shared<detail::snapshot::ElementSource<T>>(*this));
+        return result;
+    }
+    else if constexpr (detail::snapshot::is_record_v<T>)
+    {
+        T result;
+
+        std::invoke([&] <std::size_t... Is> (std::index_sequence<Is...>)
+        {
+            static constexpr auto kMemberIndices = detail::field_member_indices<T>();
+            (field<Is>().assignTo(boost::pfr::get<kMemberIndices[Is]>(result), SnapshotLoading::lazy), ...);
+        }, std::make_index_sequence<Record<T>::kFieldNames.size()>());
+
+        return result;
+    }
+    else
+    {
+        return materialize();
+    }
+}
+
+template <typename T>
+template <typename Target>
+void SnapshotView<T>::assignTo(Target& target, SnapshotLoading loading) const
+{
+    if (loading == SnapshotLoading::eager)
+    {
+        target = materialize();
+    }
+    else if constexpr (detail::snapshot::is_array<T>::value || detail::snapshot::is_map<T>::value)
+    {
+        target.setLazySource(std::make_shared<detail::snapshot::ElementSource<T>>(*this));
+    }
+    else if constexpr (detail::snapshot::is_record_v<T>)
+    {
+        // assign field by field: assigning a whole T would copy the lazy containers into target's
+        std::invoke([&] <std::size_t... Is> (std::index_sequence<Is...>)
+        {
+            auto fields = target.fields();
+            (field<Is>().assignTo(std::get<Is>(fields), loading), ...);
+        }, std::make_index_sequence<Record<T>::kFieldNames.size()>());
+    }
+    else
+    {
+        target = materialize();
+    }
+}
+
+template <typename T>
+std::vector<std::byte> writeSnapshot(Record<T> const& record)
+{
+    detail::snapshot::Writer writer;
+
+    SnapshotHeader header;
+    header.schemaHash = Record<T>::kSchemaHash;
+    header.rootOffset = detail::snapshot::writeNode<T>(writer, record);
+    header.size = writer.buffer.size();
+    std::memcpy(writer.buffer.data(), &header, sizeof(header));
+
+    return std::move(writer.buffer);
+}
+
+template <typename T>
+bool writeSnapshot(Record<T> const& record, std::filesystem::path const& path)
+{
+    auto const bytes = writeSnapshot(record);
+
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<char const*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+    return stream.good();
+}
+
+template <typename T>
+std::optional<SnapshotView<T>> openSnapshot(std::span<std::byte const> snapshot)
+{
+    SnapshotHeader header;
+
+    if (snapshot.size() < sizeof(header))
+        return std::nullopt;
+
+    std::memcpy(&header, snapshot.data(), sizeof(header));
+
+    if (header.magic != SnapshotHeader::kMagic || header.version != SnapshotHeader::kVersion
+          || header.schemaHash != Record<T>::kSchemaHash || header.size != snapshot.size())
+        return std::nullopt;
+
+    SnapshotView<T> root(snapshot, header.rootOffset);
+
+    if (! root.isValid())
+        return std::nullopt;
+
+    return root;
+}
+
+template <typename T>
+bool loadSnapshot(std::span<std::byte const> snapshot, Record<T>& record, SnapshotLoading loading)
+{
+    auto const root = openSnapshot<T>(snapshot);
+
+    if (! root)
+        return false;
+
+    if (loading == SnapshotLoading::eager)
+        record.set(root->materialize());
+    else
+        root->assignTo(record, loading);
+
+    return true;
+}
+
+//=============================================================================
+// MappedFile implementation
+//=============================================================================
+inline MappedFile::MappedFile(std::filesystem::path const& path)
+{
+   #if DYNAMIC_SNAPSHOT_MMAP
+    auto const fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+        return;
+
+    struct stat info {};
+
+    if (::fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        return;
+    }
+
+    if (info.st_size > 0)
+    {
+        auto* mapping = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapping != MAP_FAILED)
+        {
+            data = mapping;
+            size = static_cast<std::size_t>(info.st_size);
+        }
+    }
+    else
+    {
+        fallback.emplace();
+    }
+
+    ::close(fd);
+   #else
+    std::ifstream stream(path, std::ios::binary);
+
+    if (! stream)
+        return;
+
+    std::vector<std::byte> contents(static_cast<std::size_t>(std::filesystem::file_size(path)));
+    stream.read(reinterpret_cast<char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+
+    if (stream)
+        fallback = std::move(contents);
+   #endif
+}
+
+inline MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+inline MappedFile::MappedFile(MappedFile&& o) noexcept
+    : data(std::exchange(o.data, nullptr)), size(std::exchange(o.size, 0)), fallback(std::exchange(o.fallback, std::nullopt))
+{}
+
+inline MappedFile& MappedFile::operator=(MappedFile&& o) noexcept
+{
+    if (this != &o)
+    {
+        unmap();
+        data = std::exchange(o.data, nullptr);
+        size = std::exchange(o.size, 0);
+        fallback = std::exchange(o.fallback, std::nullopt);
+    }
+
+    return *this;
+}
+
+inline void MappedFile::unmap()
+{
+   #if DYNAMIC_SNAPSHOT_MMAP
+    if (data != nullptr)
+        ::munmap(data, size);
+   #endif
+
+    data = nullptr;
+    size = 0;
+}
+
+} // namespace dynamic
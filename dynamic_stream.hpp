@@ -0,0 +1,322 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <coroutine>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "dynamic.hpp"
+#include "dynamic_diff.hpp"
+
+namespace dynamic
+{
+
+/// What happens to a change which arrives while the buffer of a ChangeStream is full
+enum class ChangeStreamOverflow
+{
+    /// The change is discarded (and counted, see ChangeStream::dropped())
+    drop,
+
+    /// A modification is merged into the buffered change of the same path (an add stays an add), even
+    /// if the buffer is not full, unless the path was removed or a change of an ancestor or descendant
+    /// was buffered after it. Changes which cannot be merged are discarded if the buffer is full.
+    coalesce,
+
+    /// The changing thread waits until the consumer made room. The consumer must run on another thread.
+    block
+};
+
+/// Options of a ChangeStream
+struct ChangeStreamOptions
+{
+    std::size_t capacity = 256;
+
+    /// Drops by default: block deadlocks if the consumer is resumed on the changing thread
+    ChangeStreamOverflow overflow = ChangeStreamOverflow::drop;
+
+    /// Resumes a consumer waiting in next() (resumed on the changing thread if empty)
+    std::function<void(std::coroutine_handle<>)> executor = {};
+};
+
+/**
+ * @brief A stream of the changes of a subtree (or leaf) which coroutines can co_await
+ *
+ * ChangeStream registers a child listener (a value listener for leaves) and
+ * buffers the changes it is notified of in a ring buffer holding up to
+ * Options::capacity changes, until a coroutine consumes them with next():
+ *
+ * @code
+ * Task watch(Record<State>& state)
+ * {
+ *     ChangeStream stream(state, { .capacity = 64, .overflow = ChangeStream::Overflow::coalesce });
+ *
+ *     while (auto change = co_await stream.next())
+ *         std::cout << change->path.toString() << std::endl;
+ * }
+ * @endcode
+ *
+ * Paths are relative to the observed object (and empty for leaves). value is a
+ * copy of the new value for Operation::add and Operation::modify, and nullptr
+ * for Operation::remove.
+ *
+ * The tree may be changed on any thread. A coroutine waiting in next() is
+ * resumed by Options::executor, or directly on the thread which made the
+ * change if no executor is given. Only one coroutine may consume a stream at a
+ * time. Destroying the stream removes its listener. The stream may outlive the
+ * observed object, whose owner can end it with close() from any thread.
+ */
+class ChangeStream
+{
+public:
+    using Overflow = ChangeStreamOverflow;
+    using Options = ChangeStreamOptions;
+
+    /// Awaitable returned by next(), yields std::nullopt once the stream is closed and drained
+    class Next
+    {
+    public:
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle);
+        std::optional<Change> await_resume();
+
+    private:
+        friend class ChangeStream;
+        explicit Next(ChangeStream& stream_) : stream(stream_) {}
+
+        ChangeStream& stream;
+    };
+
+    /// Streams the changes of object and its descendants
+    explicit ChangeStream(Object& object, Options options = {});
+
+    /// Streams the changes of a leaf
+    template <typename T>
+    explicit ChangeStream(Fundamental<T> const& leaf, Options options = {}) requires Fundamental<T>::kIsOpaque;
+
+    ChangeStream(ChangeStream&&) = default;
+    ChangeStream& operator=(ChangeStream&&) = delete;
+
+    /// Removes the listener and releases a blocked writer. A waiting consumer is not resumed.
+    ~ChangeStream();
+
+    /// Returns the next change, waiting for it if none is buffered
+    Next next() { return Next(*this); }
+
+    /// Ends the stream: next() yields the buffered changes, then std::nullopt. Can be called from any thread.
+    void close();
+
+    /// Number of changes discarded because the buffer was full
+    std::size_t dropped() const;
+
+private:
+    struct State
+    {
+        explicit State(Options&& options_);
+
+        void push(ID const& path, Object::Operation op, Value const& value);
+        bool coalesce(ID const& path, Object::Operation op, std::unique_ptr<Value>& value);
+        void resume(std::coroutine_handle<> handle) const;
+
+        Options options;
+
+        mutable std::mutex mutex;
+        std::condition_variable space;
+        std::vector<Change> ring;
+        std::size_t head = 0, count = 0, numDropped = 0;
+        std::coroutine_handle<> waiter = {};
+        bool closed = false;
+    };
+
+    std::shared_ptr<State> state;
+    ListenerToken token;
+};
+
+/// Returns a stream of the changes of object and its descendants, see ChangeStream
+inline ChangeStream changes(Object& object, ChangeStreamOptions options = {})
+{
+    return ChangeStream(object, std::move(options));
+}
+
+/// Returns a stream of the changes of a leaf, see ChangeStream
+template <typename T>
+ChangeStream changes(Fundamental<T> const& leaf, ChangeStreamOptions options = {}) requires Fundamental<T>::kIsOpaque
+{
+    return ChangeStream(leaf, std::move(options));
+}
+
+//=============================================================================
+// Implementation
+//=============================================================================
+inline ChangeStream::State::State(Options&& options_) : options(std::move(options_)), ring(std::max<std::size_t>(options.capacity, 1)) {}
+
+inline void ChangeStream::State::push(ID const& path, Object::Operation op, Value const& value)
+{
+    // copy the value before locking: the consumer should not wait for it
+    std::unique_ptr<Value> copy;
+
+    if (op != Object::Operation::remove)
+    {
+        copy = value.metaType().construct();
+        copy->assign(value);
+    }
+
+    std::unique_lock lock(mutex);
+
+    if (closed)
+        return;
+
+    if (options.overflow == Overflow::coalesce && coalesce(path, op, copy))
+        return;
+
+    if (count == ring.size())
+    {
+        if (options.overflow != Overflow::block)
+        {
+            ++numDropped;
+            return;
+        }
+
+        space.wait(lock, [this] { return count < ring.size() || closed; });
+
+        if (closed)
+            return;
+    }
+
+    ring[(head + count) % ring.size()] = Change{ path, op, std::move(copy) };
+    ++count;
+
+    auto const handle = std::exchange(waiter, {});
+    lock.unlock();
+
+    if (handle)
+        resume(handle);
+}
+
+inline bool ChangeStream::State::coalesce(ID const& path, Object::Operation op, std::unique_ptr<Value>& value)
+{
+    auto const isPrefix = [] (ID const& prefix, ID const& id)
+    {
+        return prefix.size() <= id.size() && std::equal(prefix.begin(), prefix.end(), id.begin());
+    };
+
+    // additions and removals keep their order
+    if (op != Object::Operation::modify)
+        return false;
+
+    for (std::size_t i = count; i > 0; --i)
+    {
+        auto& buffered = ring[(head + i - 1) % ring.size()];
+
+        if (! (buffered.path == path))
+        {
+            // moving the change before a change of an ancestor or descendant would reorder them
+            if (isPrefix(buffered.path, path) || isPrefix(path, buffered.path))
+                return false;
+
+            continue;
+        }
+
+        if (buffered.operation == Object::Operation::remove)
+            return false;
+
+        buffered.value = std::move(value);
+        return true;
+    }
+
+    return false;
+}
+
+inline void ChangeStream::State::resume(std::coroutine_handle<> handle) const
+{
+    if (options.executor)
+        options.executor(handle);
+    else
+        handle.resume();
+}
+
+inline ChangeStream::ChangeStream(Object& object, Options options)
+    : state(std::make_shared<State>(std::move(options)))
+{
+    token = object.addChildListener([s = state] (ID const& path, Object::Operation op, Object const&, Value const& value)
+    {
+        s->push(path, op, value);
+    });
+}
+
+template <typename T>
+ChangeStream::ChangeStream(Fundamental<T> const& leaf, Options options) requires Fundamental<T>::kIsOpaque
+    : state(std::make_shared<State>(std::move(options)))
+{
+    token = leaf.addListener([s = state] (Fundamental<T> const& value)
+    {
+        s->push(ID(), Object::Operation::modify, value);
+    });
+}
+
+inline ChangeStream::~ChangeStream()
+{
+    if (state == nullptr)
+        return;
+
+    // usually destroyed with the frame of the consumer, which must not be resumed anymore
+    {
+        std::lock_guard lock(state->mutex);
+        state->closed = true;
+        state->waiter = {};
+    }
+
+    state->space.notify_all();
+}
+
+inline void ChangeStream::close()
+{
+    std::unique_lock lock(state->mutex);
+    state->closed = true;
+    auto const handle = std::exchange(state->waiter, {});
+    lock.unlock();
+
+    state->space.notify_all();
+
+    if (handle)
+        state->resume(handle);
+}
+
+inline std::size_t ChangeStream::dropped() const
+{
+    std::lock_guard lock(state->mutex);
+    return state->numDropped;
+}
+
+inline bool ChangeStream::Next::await_suspend(std::coroutine_handle<> handle)
+{
+    auto& s = *stream.state;
+    std::lock_guard lock(s.mutex);
+
+    if (s.count > 0 || s.closed)
+        return false;
+
+    s.waiter = handle;
+    return true;
+}
+
+inline std::optional<Change> ChangeStream::Next::await_resume()
+{
+    auto& s = *stream.state;
+    std::unique_lock lock(s.mutex);
+
+    if (s.count == 0)
+        return std::nullopt;
+
+    auto change = std::move(s.ring[s.head]);
+    s.head = (s.head + 1) % s.ring.size();
+    --s.count;
+    lock.unlock();
+
+    s.space.notify_one();
+    return change;
+}
+
+} // namespace dynamic
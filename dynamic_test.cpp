@@ -1,8 +1,19 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "3rdparty/doctest/doctest.h"
 #include "dynamic.hpp"
+#include "dynamic_wire.hpp"
+#include "dynamic_snapshot.hpp"
+#include "dynamic_diff.hpp"
+#include "dynamic_parallel.hpp"
+#include "dynamic_concurrent.hpp"
+#include "dynamic_stream.hpp"
+#include "dynamic_ring.hpp"
+#include <cstdlib>
+#include <cstring>
 #include <format>
 #include <sstream>
+#include <memory_resource>
+#include <new>
 
 using namespace dynamic;
 
@@ -35,6 +46,126 @@ struct WithContainers {
     Field<std::string, "name"> name;
 };
 
+struct Layer {
+    Field<Array<int32_t>, "values"> values;
+};
+
+struct Scene {
+    Field<Array<Layer>, "layers"> layers;
+    Field<Map<int32_t>, "tags"> tags;
+};
+
+struct Quote {
+    Field<double, "bid"> bid;
+    Field<double, "ask"> ask;
+};
+
+struct Market {
+    Field<bool, "open"> open;
+    Field<ConcurrentMap<Quote>, "quotes"> quotes;
+};
+
+struct Mixed {
+    int8_t tag = 0;
+    Field<double, "value"> value;
+    std::string note;
+    Field<bool, "flag"> flag;
+    Field<Array<int32_t>, "items"> items;
+    Field<Point, "point"> point;
+};
+
+struct Aligned {
+    Field<int8_t, "small"> small;
+    alignas(64) Field<int32_t, "wide"> wide;
+};
+
+struct Order {
+    Field<std::chrono::nanoseconds, "timestamp"> timestamp;
+    Field<Symbol, "symbol"> symbol;
+    Field<FixedPrice, "price"> price;
+};
+
+struct Telemetry {
+    Field<std::string, "source"> source;
+    Field<Array<double>, "samples"> samples;
+};
+
+DYNAMIC_REGISTER_RECORD(Telemetry, "test.Telemetry")
+
+struct PointCopy {
+    Field<float, "x"> x;
+    Field<float, "y"> y;
+};
+
+struct PointRenamed {
+    Field<float, "x"> x;
+    Field<float, "z"> z;
+};
+
+struct PointRetyped {
+    Field<float, "x"> x;
+    Field<double, "y"> y;
+};
+
+struct Message {
+    Field<std::string, "name"> name;
+    Field<Array<Point>, "points"> points;
+    Field<Map<int32_t>, "scores"> scores;
+    Field<FixedPrice, "price"> price;
+    Field<ID, "path"> path;
+};
+
+// Message as seen by a newer receiver: reordered, one field retyped, one added, one removed
+struct MessageV2 {
+    Field<Map<int32_t>, "scores"> scores;
+    Field<std::string, "name"> name;
+    Field<double, "price"> price;
+    Field<bool, "urgent"> urgent;
+    Field<Array<Point>, "points"> points;
+};
+
+// keeps area up to date with hooks on width and height
+struct UpdateArea;
+
+struct Rect {
+    Field<float, "width", UpdateArea> width;
+    Field<float, "height", UpdateArea> height;
+    Field<float, "area"> area;
+};
+
+struct UpdateArea {
+    static inline int calls = 0;
+
+    template <typename FieldType>
+    static void changed(FieldType&, Object* parent)
+    {
+        ++calls;
+
+        if (parent != nullptr)
+        {
+            auto& rect = static_cast<Record<Rect>&>(*parent);
+            rect->area = rect->width() * rect->height();
+        }
+    }
+};
+
+struct Width {
+    static inline int evaluations = 0;
+
+    float operator()(Point const& start, Point const& finish) const
+    {
+        ++evaluations;
+        return finish.x() - start.x();
+    }
+};
+
+struct Span {
+    Field<Point, "start"> start;
+    Field<Point, "finish"> finish;
+    Field<std::string, "label"> label;
+    Computed<float, "width", Width, "start", "finish"> width;
+};
+
 //=============================================================================
 // ID tests
 //=============================================================================
@@ -178,6 +309,51 @@ TEST_CASE("int64_t") {
     CHECK(val() == 999999999999LL);
 }
 
+TEST_CASE("unsigned integers") {
+    Fundamental<uint8_t> u8;
+    u8 = static_cast<uint8_t>(255);
+    CHECK(u8() == 255);
+    CHECK(u8.type() == typeid(uint8_t));
+
+    Fundamental<uint16_t> u16(static_cast<uint16_t>(65535));
+    CHECK(u16() == 65535);
+
+    Fundamental<uint32_t> u32(4000000000u);
+    CHECK(u32() == 4000000000u);
+
+    Fundamental<uint64_t> u64;
+    int callCount = 0;
+    auto token = u64.addListener([&callCount](auto const&) { ++callCount; });
+    u64 = std::numeric_limits<uint64_t>::max();
+    CHECK(u64() == std::numeric_limits<uint64_t>::max());
+    CHECK(callCount == 1);
+}
+
+TEST_CASE("unsigned integers in visit, MetaType and format") {
+    Fundamental<uint64_t> val(18446744073709551615ull);
+    Value& ref = val;
+
+    ref.visit([](uint64_t& v) { v -= 15; });
+    CHECK(val() == 18446744073709551600ull);
+    CHECK(std::format("{}", static_cast<Value const&>(val)) == "18446744073709551600");
+
+    auto const& meta = metaTypeOf<uint32_t>();
+    CHECK(meta.isOpaque());
+    CHECK(meta.typeInfo() == typeid(uint32_t));
+    CHECK(meta.construct()->type() == typeid(uint32_t));
+}
+
+TEST_CASE("long double") {
+    Fundamental<long double> val;
+    val = 1.5L;
+    CHECK(val() == 1.5L);
+    CHECK(val.type() == typeid(long double));
+
+    std::ostringstream ss;
+    ss << static_cast<Value const&>(val);
+    CHECK(ss.str() == "1.5");
+}
+
 TEST_CASE("float") {
     Fundamental<float> val;
     val = 3.14f;
@@ -356,6 +532,89 @@ TEST_CASE("comparison") {
 
 } // TEST_SUITE("Fundamental<bool>")
 
+//=============================================================================
+// Extra fundamental type tests
+//=============================================================================
+
+TEST_SUITE("Extra fundamental types") {
+
+TEST_CASE("registered types are fundamental leaves") {
+    CHECK(Value::isOpaque<std::chrono::nanoseconds>());
+    CHECK(Value::isOpaque<Symbol>());
+    CHECK(std::is_base_of_v<Fundamental<Symbol>, Field<Symbol, "symbol">>);
+    CHECK(std::is_base_of_v<Fundamental<FixedPrice>, Field<FixedPrice, "price">>);
+}
+
+TEST_CASE("visit dispatches registered types") {
+    Fundamental<std::chrono::nanoseconds> ts(std::chrono::nanoseconds(5));
+    Value& v = ts;
+
+    int64_t seen = 0;
+    static_cast<Value const&>(v).visit([&seen] (std::chrono::nanoseconds const& ns) { seen = ns.count(); });
+    CHECK(seen == 5);
+
+    auto const isInt = v.visit([] (auto const& x) { return std::is_same_v<std::remove_cvref_t<decltype(x)>, int32_t>; });
+    CHECK_FALSE(isInt);
+}
+
+TEST_CASE("mutable visit of registered type notifies listeners") {
+    Fundamental<FixedPrice> price(FixedPrice{100});
+    int callCount = 0;
+    auto token = price.addListener([&callCount] (auto const&) { ++callCount; });
+
+    static_cast<Value&>(price).visit([] (FixedPrice& p) { p.ticks += 5; });
+    CHECK(price().ticks == 105);
+    CHECK(callCount == 1);
+
+    static_cast<Value&>(price).visit([] (FixedPrice&) {});
+    CHECK(callCount == 1);
+}
+
+TEST_CASE("registered types in records") {
+    Record<Order> order;
+    ID changedPath;
+    auto token = order.addChildListener([&changedPath] (ID const& path, Object::Operation, Object const&, Value const&) { changedPath = path; });
+
+    order("symbol"_fld) = Symbol{{'A', 'B', 'C'}};
+    CHECK(changedPath.toString() == "symbol");
+    CHECK(order("symbol"_fld)().chars[2] == 'C');
+
+    order("timestamp"_fld) = std::chrono::nanoseconds(42);
+    CHECK(changedPath.toString() == "timestamp");
+    CHECK(order("timestamp"_fld)().count() == 42);
+}
+
+TEST_CASE("MetaType of registered types") {
+    auto const& meta = metaTypeOf<FixedPrice>();
+    CHECK(meta.isOpaque());
+    CHECK(meta.typeInfo() == typeid(FixedPrice));
+
+    auto instance = meta.construct();
+    REQUIRE(instance != nullptr);
+    CHECK(instance->assign(Fundamental<FixedPrice>(FixedPrice{7})));
+    CHECK(static_cast<Fundamental<FixedPrice>&>(*instance)().ticks == 7);
+
+    auto const& fields = metaTypeOf<Order>().fields();
+    REQUIRE(fields.size() == 3);
+    CHECK(&fields[2].metaType() == &meta);
+}
+
+TEST_CASE("stream output of registered types") {
+    Fundamental<FixedPrice> price(FixedPrice{3});
+    std::ostringstream ss;
+    ss << static_cast<Value const&>(price);
+    CHECK(ss.str() == "3t");
+    CHECK(std::format("{}", static_cast<Value const&>(price)) == "3t");
+
+    Record<Order> order;
+    order("symbol"_fld) = Symbol{{'X', 'Y'}};
+    std::ostringstream ss2;
+    ss2 << static_cast<Object const&>(order);
+    CHECK(ss2.str().find(".symbol = XY") != std::string::npos);
+}
+
+} // TEST_SUITE("Extra fundamental types")
+
 //=============================================================================
 // Record tests
 //=============================================================================
@@ -410,6 +669,22 @@ TEST_CASE("typeErasedFields") {
     CHECK(fields[1].get().fieldname() == "y");
 }
 
+TEST_CASE("fieldRange") {
+    Record<Point> point;
+    point("x"_fld) = 1.0f;
+
+    std::vector<std::string> names;
+    for (auto& fld : static_cast<Object&>(point).fieldRange())
+        names.push_back(fld.fieldname());
+
+    CHECK(names == std::vector<std::string> { "x", "y" });
+
+    auto const range = static_cast<Object const&>(point).fieldRange();
+    CHECK(range.size() == 2);
+    CHECK(&range[0] == &point("x"_fld));
+    CHECK(std::distance(range.begin(), range.end()) == 2);
+}
+
 TEST_CASE("visitFields") {
     Record<Point> point;
     point("x"_fld) = 10.0f;
@@ -603,6 +878,89 @@ TEST_CASE("visit Invalid") {
     CHECK(visitedInvalid);
 }
 
+TEST_CASE("visit dispatches every supported fundamental type") {
+    Fundamental<int8_t> i8(1);
+    Fundamental<int16_t> i16(2);
+    Fundamental<int64_t> i64(3);
+    Fundamental<uint8_t> u8(7);
+    Fundamental<uint64_t> u64(8);
+    Fundamental<double> dbl(4.0);
+    Fundamental<long double> ldbl(6.0L);
+    Fundamental<std::string> str(std::string("five"));
+
+    std::vector<std::string> seen;
+    for (Value const* v : std::initializer_list<Value const*>{ &i8, &i16, &i64, &u8, &u64, &dbl, &ldbl, &str }) {
+        v->visit([&seen](auto const& x) {
+            using Type = std::remove_cvref_t<decltype(x)>;
+            if constexpr (std::is_same_v<Type, int8_t>) seen.push_back("int8");
+            else if constexpr (std::is_same_v<Type, int16_t>) seen.push_back("int16");
+            else if constexpr (std::is_same_v<Type, int64_t>) seen.push_back("int64");
+            else if constexpr (std::is_same_v<Type, uint8_t>) seen.push_back("uint8");
+            else if constexpr (std::is_same_v<Type, uint64_t>) seen.push_back("uint64");
+            else if constexpr (std::is_same_v<Type, double>) seen.push_back("double");
+            else if constexpr (std::is_same_v<Type, long double>) seen.push_back("long double");
+            else if constexpr (std::is_same_v<Type, std::string>) seen.push_back("string");
+            else seen.push_back("other");
+        });
+    }
+
+    CHECK(seen == std::vector<std::string>{ "int8", "int16", "int64", "uint8", "uint64", "double", "long double", "string" });
+}
+
+TEST_CASE("visit returns the lambda's result") {
+    Fundamental<int32_t> val(21);
+    Value& ref = val;
+    auto doubled = ref.visit([](int32_t& v) { return v * 2; });
+    CHECK(doubled == 42);
+    CHECK(val() == 21);
+}
+
+TEST_CASE("mutable visit notifies listeners exactly once") {
+    Fundamental<int32_t> val(10);
+    int callCount = 0;
+    auto token = val.addListener([&callCount](auto const&) { ++callCount; });
+
+    Value& ref = val;
+    ref.visit([](int32_t& v) { v += 1; v += 1; });
+
+    CHECK(val() == 12);
+    CHECK(callCount == 1);
+}
+
+TEST_CASE("mutable visit without change does not notify") {
+    Fundamental<std::string> val(std::string("same"));
+    int callCount = 0;
+    auto token = val.addListener([&callCount](auto const&) { ++callCount; });
+
+    Value& ref = val;
+    ref.visit([](std::string& s) { s = "same"; });
+
+    CHECK(callCount == 0);
+}
+
+TEST_CASE("mutable visit on record field propagates to child listeners") {
+    Record<Point> point;
+    int callCount = 0;
+    auto token = point.addChildListener([&callCount](ID const& id, Object::Operation op, Object const&, Value const& v) {
+        CHECK(id.toString() == "x");
+        CHECK(op == Object::Operation::modify);
+        CHECK(static_cast<Fundamental<float> const&>(v)() == doctest::Approx(2.5f));
+        ++callCount;
+    });
+
+    Value& x = point("x"_fld);
+    x.visit([](float& f) { f = 2.5f; });
+    CHECK(callCount == 1);
+}
+
+TEST_CASE("visit with lambda not supporting the type is a no-op") {
+    Fundamental<float> val(1.0f);
+    Value& ref = val;
+    bool visited = false;
+    ref.visit([&visited](int32_t&) { visited = true; });
+    CHECK_FALSE(visited);
+}
+
 } // TEST_SUITE("Visitor")
 
 //=============================================================================
@@ -708,6 +1066,28 @@ TEST_CASE("weak_ptr-based listener stops when context destroyed") {
     CHECK(callCount == 1);
 }
 
+TEST_CASE("listeners bound by a liveness check survive other context-bound listeners") {
+    detail::ListenerList<std::function<void()>> list;
+    bool alive = true;
+    int whileCalls = 0, contextCalls = 0;
+
+    list.addWhile([&alive] { return alive; }, [&whileCalls] { ++whileCalls; });
+
+    auto context = std::make_shared<int>(0);
+    list.add(context, [&contextCalls] { ++contextCalls; });
+
+    list.call();
+    CHECK(whileCalls == 1);
+    CHECK(contextCalls == 1);
+
+    alive = false;
+    context.reset();
+    list.add(std::make_shared<int>(0), [] {});
+    list.call();
+    CHECK(whileCalls == 1);
+    CHECK(contextCalls == 1);
+}
+
 TEST_CASE("child listener on Record") {
     Record<Point> point;
     int callCount = 0;
@@ -749,6 +1129,35 @@ TEST_CASE("child listener propagation through nested hierarchy") {
     CHECK(lastPath == "finish/y");
 }
 
+TEST_CASE("assigning a nested record notifies once for the record") {
+    Record<Line> line, other;
+    std::vector<std::string> paths, otherPaths;
+
+    auto token = line.addChildListener([&] (ID const& id, Object::Operation, Object const&, Value const&)
+    {
+        paths.push_back(id.toString());
+
+        // the suppression of the fields' notifications is scoped to line's tree
+        Point q;
+        q.x = static_cast<float>(paths.size());
+        other("finish"_fld) = q;
+    });
+
+    auto otherToken = other.addChildListener([&otherPaths] (ID const& id, Object::Operation, Object const&, Value const&)
+    {
+        otherPaths.push_back(id.toString());
+    });
+
+    Point p;
+    p.x = 1.0f;
+    p.y = 2.0f;
+    line("start"_fld) = p;
+
+    CHECK(paths == std::vector<std::string>{ "start" });
+    CHECK(otherPaths == std::vector<std::string>{ "finish" });
+    CHECK(line("start"_fld)("y"_fld)() == 2.0f);
+}
+
 TEST_CASE("child listener token removal") {
     Record<Point> point;
     int callCount = 0;
@@ -812,6 +1221,98 @@ TEST_CASE("listener on string value") {
     CHECK(lastValue == "world");
 }
 
+TEST_CASE("listeners added or removed during dispatch take effect on the next change") {
+    Fundamental<int32_t> val;
+    int firstCalls = 0, addedCalls = 0;
+    ListenerToken added;
+    std::optional<ListenerToken> first;
+
+    first = val.addListener([&] (auto const&) {
+        ++firstCalls;
+        added = val.addListener([&addedCalls] (auto const&) { ++addedCalls; });
+        first.reset();
+    });
+
+    val = 1;
+    CHECK(firstCalls == 1);
+    CHECK(addedCalls == 0);
+
+    val = 2;
+    CHECK(firstCalls == 1);
+    CHECK(addedCalls == 1);
+}
+
+TEST_CASE("listeners can be registered from other threads while changes are dispatched") {
+    Record<Point> point;
+    std::atomic<int> calls = 0;
+    auto token = point.addChildListener([&calls] (ID const&, Object::Operation, Object const&, Value const&) { ++calls; });
+
+    std::atomic<bool> done = false;
+    std::thread registrar([&point, &done]
+    {
+        while (! done.load())
+        {
+            auto transient = point.addChildListener([] (ID const&, Object::Operation, Object const&, Value const&) {});
+            auto other = point("x"_fld).addListener([] (auto const&) {});
+        }
+    });
+
+    for (int i = 1; i <= 10000; ++i)
+        point("x"_fld) = static_cast<float>(i);
+
+    done = true;
+    registrar.join();
+
+    CHECK(calls.load() == 10000);
+}
+
+TEST_CASE("coalesced child listeners receive the latest value per path") {
+    Record<State> state;
+    std::map<std::string, float> delivered;
+    int calls = 0;
+
+    auto token = state.addCoalescedChildListener(std::chrono::hours(1), [&] (ID const& path, Value const& value) {
+        ++calls;
+        delivered[path.toString()] = static_cast<Fundamental<float> const&>(value)();
+    });
+
+    for (int i = 1; i <= 100; ++i)
+        state("line"_fld)("start"_fld)("x"_fld) = static_cast<float>(i);
+
+    state("line"_fld)("finish"_fld)("y"_fld) = 7.0f;
+
+    // the interval has not passed yet
+    CHECK(calls == 0);
+
+    state.flushCoalescedChildListeners();
+    CHECK(calls == 2);
+    CHECK(delivered["line/start/x"] == 100.0f);
+    CHECK(delivered["line/finish/y"] == 7.0f);
+
+    // nothing changed since the last delivery
+    state.flushCoalescedChildListeners();
+    CHECK(calls == 2);
+
+    token = {};
+    state("line"_fld)("start"_fld)("x"_fld) = 1.0f;
+    state.flushCoalescedChildListeners();
+    CHECK(calls == 2);
+}
+
+TEST_CASE("coalesced child listeners without interval are called on every change") {
+    Record<State> state;
+    std::vector<std::string> paths;
+
+    auto token = state.addCoalescedChildListener(std::chrono::nanoseconds(0), [&] (ID const& path, Value const&) {
+        paths.push_back(path.toString());
+    });
+
+    state("count"_fld) = 1;
+    state("line"_fld)("start"_fld)("y"_fld) = 2.0f;
+
+    CHECK(paths == std::vector<std::string>{ "count", "line/start/y" });
+}
+
 } // TEST_SUITE("Listeners")
 
 //=============================================================================
@@ -1123,6 +1624,19 @@ TEST_CASE("typeErasedFields") {
     CHECK(fields.size() == 2);
 }
 
+TEST_CASE("fieldRange") {
+    Map<int32_t> map;
+    map.addElement("a", 1);
+    map.addElement("b", 2);
+
+    int32_t sum = 0;
+    for (auto& fld : static_cast<Object&>(map).fieldRange())
+        fld.visit([&sum] (int32_t& x) { x *= 10; sum += x; });
+
+    CHECK(sum == 30);
+    CHECK(map["b"]() == 20);
+}
+
 TEST_CASE("addElement with existing key updates value") {
     Map<int32_t> map;
     map.addElement("key", 10);
@@ -1173,6 +1687,20 @@ TEST_CASE("map listener fires on remove") {
     CHECK(lastOp == Object::Operation::remove);
 }
 
+TEST_CASE("elements moved by a removal do not notify") {
+    Map<int32_t> map;
+    map.addElement("a", 1);
+    map.addElement("b", 2);
+
+    std::vector<Object::Operation> ops;
+    auto token = map.addChildListener([&ops] (ID const&, Object::Operation op, Object const&, Value const&) {
+        ops.push_back(op);
+    });
+
+    map.removeElement("a");
+    CHECK(ops == std::vector<Object::Operation>{ Object::Operation::remove });
+}
+
 TEST_CASE("map of structs") {
     Map<Point> map;
     Point p; p.x = 1.0f; p.y = 2.0f;
@@ -1251,52 +1779,1738 @@ TEST_CASE("map type") {
     CHECK(map.type() == typeid(Map<int32_t>));
 }
 
-} // TEST_SUITE("Map")
+TEST_CASE("MapKey stores short keys inline") {
+    MapKey shortKey("EURUSD");
+    CHECK(shortKey.isInline());
+    CHECK(shortKey.view() == "EURUSD");
+    CHECK(shortKey.hash() == MapKey::hashOf("EURUSD"));
 
-//=============================================================================
-// Stream and format output tests
-//=============================================================================
+    MapKey longKey("a-key-that-is-longer-than-fifteen");
+    CHECK_FALSE(longKey.isInline());
+    CHECK(longKey.view() == "a-key-that-is-longer-than-fifteen");
 
-TEST_SUITE("Stream output") {
+    MapKey copy = longKey;
+    CHECK(copy == longKey);
+    CHECK(copy.view().data() != longKey.view().data());
 
-TEST_CASE("Value stream output") {
-    Fundamental<int32_t> val(42);
-    std::ostringstream ss;
-    ss << static_cast<Value const&>(val);
-    CHECK(ss.str() == "42");
-}
+    MapKey moved = std::move(copy);
+    CHECK(moved == longKey);
+    CHECK(copy.size() == 0);
 
-TEST_CASE("Object stream output") {
-    Record<Point> point;
-    point("x"_fld) = 1.0f;
-    point("y"_fld) = 2.0f;
-    std::ostringstream ss;
-    ss << static_cast<Object const&>(point);
-    std::string result = ss.str();
-    CHECK(result.find(".x = ") != std::string::npos);
-    CHECK(result.find(".y = ") != std::string::npos);
+    CHECK(MapKey("abc") == MapKey("abc"));
+    CHECK(MapKey("abc") != MapKey("abd"));
+    CHECK(MapKey("abc") != MapKey("abc-and-more-characters"));
+    CHECK(std::hash<MapKey>{}(shortKey) == shortKey.hash());
 }
 
-TEST_CASE("std::format with Value") {
-    Fundamental<int32_t> val(123);
-    CHECK(std::format("{}", static_cast<Value const&>(val)) == "123");
-}
+TEST_CASE("MapKey overloads") {
+    Map<int32_t> map;
+    MapKey const one("one");
+    MapKey const longKey("a-key-that-is-longer-than-fifteen");
 
-TEST_CASE("std::format with Object") {
-    Record<Point> point;
-    point("x"_fld) = 1.0f;
-    point("y"_fld) = 2.0f;
-    auto result = std::format("{}", static_cast<Object const&>(point));
-    CHECK(result.find(".x = ") != std::string::npos);
-}
+    map.addElement(one, 1);
+    map.addElement(longKey, 2);
+    map.addElement("three", 3);
 
-TEST_CASE("std::format with ID") {
-    auto id = ID::fromString("a/b/c");
-    CHECK(std::format("{}", id) == "a/b/c");
+    CHECK(map.contains(one));
+    CHECK(map.contains("one"));
+    CHECK(map.contains(MapKey("three")));
+    CHECK(map[one]() == 1);
+    CHECK(map[longKey]() == 2);
+    CHECK(map.find(longKey) != map.end());
+    CHECK(map.find(MapKey("missing")) == map.end());
+
+    map.addElement(one, 10);
+    CHECK(map.size() == 3);
+    CHECK(map["one"]() == 10);
+
+    CHECK(map.removeElement(longKey));
+    CHECK_FALSE(map.contains("a-key-that-is-longer-than-fifteen"));
+    CHECK(static_cast<Object&>(map)("one").fieldname() == "one");
 }
 
-TEST_CASE("bool stream output") {
-    Fundamental<bool> val;
+TEST_CASE("remove listener receives key of removed element") {
+    Map<int32_t> map;
+    map.addElement("a-key-that-is-longer-than-fifteen", 1);
+    map.addElement("b", 2);
+
+    std::vector<std::string> removedKeys;
+    auto token = map.addListener([&removedKeys](Object::Operation op, auto const&, auto const&, std::string_view key) {
+        if (op == Object::Operation::remove)
+            removedKeys.emplace_back(key);
+    });
+
+    // assign removes all existing elements, passing each element's own key
+    Map<int32_t> other;
+    map.assign(other);
+    CHECK(removedKeys == std::vector<std::string>{ "b", "a-key-that-is-longer-than-fifteen" });
+}
+
+} // TEST_SUITE("Map")
+
+//=============================================================================
+// Wire format tests
+//=============================================================================
+
+TEST_SUITE("Wire format") {
+
+namespace
+{
+Record<Message> makeMessage()
+{
+    Record<Message> message;
+    message("name"_fld) = std::string("order");
+    message("points"_fld).addElement(Point{ {}, {} });
+    message("points"_fld)[0]("x"_fld) = 1.5f;
+    message("scores"_fld).addElement("alice", 3);
+    message("scores"_fld).addElement("bob", 5);
+    message("price"_fld) = FixedPrice{ 1250 };
+    message("path"_fld) = ID::fromString("a/b");
+    return message;
+}
+} // namespace
+
+TEST_CASE("schema hash is usable at compile time") {
+    static_assert(Record<Point>::kSchemaHash == Record<PointCopy>::kSchemaHash);
+    static_assert(Record<Message>::kSchemaHash != Record<MessageV2>::kSchemaHash);
+    CHECK(Record<Message>::kSchemaHash == Record<Message>::meta().schemaHash());
+}
+
+TEST_CASE("positional round trip") {
+    auto const message = makeMessage();
+    auto const bytes = encode(message);
+
+    auto const header = peekWireHeader(bytes);
+    REQUIRE(header.has_value());
+    CHECK(header->encoding == WireEncoding::positional);
+    CHECK(header->schemaHash == Record<Message>::kSchemaHash);
+
+    Record<Message> received;
+    int callCount = 0;
+    auto token = received.addListener([&callCount] (auto const&) { ++callCount; });
+
+    REQUIRE(decode(bytes, received));
+    CHECK(callCount == 1);
+    CHECK(received("name"_fld)() == "order");
+    REQUIRE(received("points"_fld).size() == 1);
+    CHECK(received("points"_fld)[0]("x"_fld)() == 1.5f);
+    CHECK(received("scores"_fld)["bob"]() == 5);
+    CHECK(received("price"_fld)().ticks == 1250);
+    CHECK(received("path"_fld)().toString() == "a/b");
+}
+
+TEST_CASE("structurally identical records decode positionally") {
+    Record<Point> point;
+    point("x"_fld) = 2.0f;
+
+    Record<PointCopy> copy;
+    REQUIRE(decode(encode(point), copy));
+    CHECK(copy("x"_fld)() == 2.0f);
+}
+
+TEST_CASE("positional message with a different schema is rejected") {
+    Record<MessageV2> received;
+    received("name"_fld) = std::string("unchanged");
+
+    CHECK_FALSE(decode(encode(makeMessage()), received));
+    CHECK(received("name"_fld)() == "unchanged");
+}
+
+TEST_CASE("tagged message decodes by name") {
+    auto const bytes = encode(makeMessage(), WireEncoding::tagged);
+    CHECK(peekWireHeader(bytes)->encoding == WireEncoding::tagged);
+
+    Record<MessageV2> received;
+    REQUIRE(decode(bytes, received));
+    CHECK(received("name"_fld)() == "order");
+    CHECK(received("scores"_fld)["alice"]() == 3);
+    REQUIRE(received("points"_fld).size() == 1);
+    CHECK(received("points"_fld)[0]("x"_fld)() == 1.5f);
+
+    // retyped and added fields keep their defaults
+    CHECK(received("price"_fld)() == 0.0);
+    CHECK_FALSE(received("urgent"_fld)());
+}
+
+TEST_CASE("tagged message decodes nested records by name") {
+    Record<Point> point;
+    point("x"_fld) = 4.0f;
+    point("y"_fld) = 5.0f;
+
+    Record<PointRenamed> renamed;
+    REQUIRE(decode(encode(point, WireEncoding::tagged), renamed));
+    CHECK(renamed("x"_fld)() == 4.0f);
+    CHECK(renamed("z"_fld)() == 0.0f);
+}
+
+TEST_CASE("malformed messages are rejected") {
+    auto bytes = encode(makeMessage(), WireEncoding::tagged);
+    Record<Message> received;
+
+    CHECK_FALSE(decode(std::span(bytes).first(bytes.size() - 1), received));
+    CHECK_FALSE(decode(std::span(bytes).first(sizeof(WireHeader) - 1), received));
+
+    bytes[0] = std::byte{ 0 };
+    CHECK_FALSE(peekWireHeader(bytes).has_value());
+    CHECK_FALSE(decode(bytes, received));
+}
+
+TEST_CASE("invalid bool leaves are rejected") {
+    Record<State> state;
+    state("active"_fld) = true;
+
+    // the bool is the last field, and thus the last byte of the message
+    auto bytes = encode(state);
+    REQUIRE(bytes.back() == std::byte{ 1 });
+
+    Record<State> received;
+    bytes.back() = std::byte{ 2 };
+    CHECK_FALSE(decode(bytes, received));
+    CHECK_FALSE(received("active"_fld)());
+}
+
+} // TEST_SUITE("Wire format")
+
+//=============================================================================
+// Snapshot tests
+//=============================================================================
+
+TEST_SUITE("Snapshot") {
+
+namespace
+{
+Record<Message> makeSnapshotMessage()
+{
+    Record<Message> message;
+    message("name"_fld) = std::string("snapshot");
+
+    for (int i = 0; i < 3; ++i)
+        message("points"_fld).addElement(Point{ {}, {} });
+
+    message("points"_fld)[2]("y"_fld) = 7.0f;
+    message("scores"_fld).addElement("alice", 3);
+    message("scores"_fld).addElement("a key longer than the inline capacity", 11);
+    message("price"_fld) = FixedPrice{ 99 };
+    message("path"_fld) = ID::fromString("x/y/z");
+    return message;
+}
+} // namespace
+
+TEST_CASE("views read values without materializing") {
+    auto const bytes = writeSnapshot(makeSnapshotMessage());
+    auto const root = openSnapshot<Message>(bytes);
+    REQUIRE(root.has_value());
+
+    CHECK(root->field<0>().get() == "snapshot");
+    CHECK((*root)("name"_fld).get() == "snapshot");
+    CHECK((*root)("price"_fld).get().ticks == 99);
+    CHECK((*root)("path"_fld).get().toString() == "x/y/z");
+
+    auto const points = (*root)("points"_fld);
+    REQUIRE(points.size() == 3);
+    CHECK(points[2]("y"_fld).get() == 7.0f);
+
+    auto const scores = (*root)("scores"_fld);
+    REQUIRE(scores.size() == 2);
+    CHECK(scores.keyAt(0) == "alice");
+    CHECK(scores.valueAt(0).get() == 3);
+    REQUIRE(scores.find("a key longer than the inline capacity").has_value());
+    CHECK(scores.find("a key longer than the inline capacity")->get() == 11);
+    CHECK_FALSE(scores.find("bob").has_value());
+}
+
+TEST_CASE("partial materialization") {
+    auto const bytes = writeSnapshot(makeSnapshotMessage());
+    auto const root = openSnapshot<Message>(bytes);
+    REQUIRE(root.has_value());
+
+    Array<Point> const points = (*root)("points"_fld).materialize();
+    REQUIRE(points.size() == 3);
+    CHECK(points[2]("y"_fld)() == 7.0f);
+
+    Map<int32_t> const scores = (*root)("scores"_fld).materialize();
+    CHECK(scores["alice"]() == 3);
+}
+
+TEST_CASE("loading a snapshot notifies once") {
+    auto const bytes = writeSnapshot(makeSnapshotMessage());
+
+    Record<Message> loaded;
+    int callCount = 0;
+    auto token = loaded.addListener([&callCount] (auto const&) { ++callCount; });
+
+    REQUIRE(loadSnapshot(bytes, loaded));
+    CHECK(callCount == 1);
+    CHECK(loaded("name"_fld)() == "snapshot");
+    CHECK(loaded("points"_fld).size() == 3);
+    CHECK(loaded("scores"_fld)["a key longer than the inline capacity"]() == 11);
+    CHECK(loaded("path"_fld)().toString() == "x/y/z");
+}
+
+TEST_CASE("snapshots of other schemas and corrupt snapshots are rejected") {
+    auto bytes = writeSnapshot(makeSnapshotMessage());
+
+    CHECK_FALSE(openSnapshot<MessageV2>(bytes).has_value());
+    CHECK_FALSE(openSnapshot<Message>(std::span(bytes).first(bytes.size() - 1)).has_value());
+
+    bytes[0] = std::byte{ 0 };
+    Record<Message> loaded;
+    CHECK_FALSE(loadSnapshot(bytes, loaded));
+}
+
+TEST_CASE("IDs with a corrupt count read as empty") {
+    auto bytes = writeSnapshot(makeSnapshotMessage());
+
+    SnapshotHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    // "path" is the fifth field of the root record
+    std::uint64_t pathOffset = 0;
+    std::memcpy(&pathOffset, bytes.data() + header.rootOffset + 4 * sizeof(std::uint64_t), sizeof(pathOffset));
+
+    std::uint64_t const count = bytes.size() / sizeof(std::uint64_t);
+    std::memcpy(bytes.data() + pathOffset, &count, sizeof(count));
+
+    auto const root = openSnapshot<Message>(bytes);
+    REQUIRE(root.has_value());
+    CHECK((*root)("path"_fld).get().empty());
+}
+
+TEST_CASE("invalid bool leaves read as false") {
+    Record<State> state;
+    auto const inactive = writeSnapshot(state);
+    state("active"_fld) = true;
+    auto bytes = writeSnapshot(state);
+
+    // the snapshots only differ in the byte of the bool
+    REQUIRE(bytes.size() == inactive.size());
+    auto const differs = std::ranges::mismatch(bytes, inactive).in1;
+    REQUIRE(differs != bytes.end());
+    REQUIRE(*differs == std::byte{ 1 });
+
+    *differs = std::byte{ 2 };
+    auto const root = openSnapshot<State>(bytes);
+    REQUIRE(root.has_value());
+    CHECK_FALSE((*root)("active"_fld).get());
+}
+
+TEST_CASE("memory mapped snapshot file") {
+    auto const path = std::filesystem::temp_directory_path() / "dynamic_test.snapshot";
+    REQUIRE(writeSnapshot(makeSnapshotMessage(), path));
+
+    {
+        MappedFile file(path);
+        REQUIRE(file.isValid());
+
+        auto const root = openSnapshot<Message>(file.bytes());
+        REQUIRE(root.has_value());
+        CHECK((*root)("points"_fld)[2]("y"_fld).get() == 7.0f);
+    }
+
+    std::filesystem::remove(path);
+    CHECK_FALSE(MappedFile(path).isValid());
+}
+
+} // TEST_SUITE("Snapshot")
+
+//=============================================================================
+// Lazy container tests
+//=============================================================================
+
+TEST_SUITE("Lazy containers") {
+
+namespace
+{
+struct CountingSource : LazyElementSource<int32_t>
+{
+    explicit CountingSource(std::size_t n_) : n(n_) {}
+
+    std::size_t size() const override { return n; }
+    int32_t element(std::size_t idx) const override { ++loads; return static_cast<int32_t>(idx * 10); }
+    std::string_view key(std::size_t idx) const override { return keys[idx]; }
+
+    std::size_t n;
+    std::array<std::string_view, 3> keys = { "a", "b", "c" };
+    mutable int loads = 0;
+};
+} // namespace
+
+TEST_CASE("size does not load elements") {
+    auto source = std::make_shared<CountingSource>(3);
+    Array<int32_t> array;
+    array.setLazySource(source);
+
+    CHECK(array.size() == 3);
+    CHECK_FALSE(array.empty());
+    CHECK_FALSE(array.isLoaded());
+    CHECK(source->loads == 0);
+
+    CHECK(array[2]() == 20);
+    CHECK(array.isLoaded());
+    CHECK(source->loads == 3);
+}
+
+TEST_CASE("iteration and getchild load elements") {
+    auto source = std::make_shared<CountingSource>(3);
+    Record<Layer> layer;
+    layer("values"_fld).setLazySource(source);
+
+    CHECK(layer.getchild(ID::fromString("values/1")).isValid());
+    CHECK(source->loads == 3);
+
+    int32_t sum = 0;
+    for (auto const& element : layer("values"_fld))
+        sum += element();
+
+    CHECK(sum == 30);
+    CHECK(source->loads == 3);
+}
+
+TEST_CASE("map lookups") {
+    auto source = std::make_shared<CountingSource>(3);
+    Map<int32_t> map;
+    map.setLazySource(source);
+
+    CHECK(map.contains("b"));
+    CHECK_FALSE(map.contains("d"));
+    CHECK(source->loads == 0);
+
+    CHECK(map["c"]() == 20);
+    CHECK(source->loads == 3);
+}
+
+TEST_CASE("compact releases unmodified containers") {
+    auto source = std::make_shared<CountingSource>(3);
+    Record<Layer> layer;
+    layer("values"_fld).setLazySource(source);
+
+    CHECK(layer.compact() == 0);
+    CHECK(layer("values"_fld)[0]() == 0);
+
+    CHECK(layer.compact() == 1);
+    CHECK_FALSE(layer("values"_fld).isLoaded());
+    CHECK(layer("values"_fld).size() == 3);
+
+    CHECK(layer("values"_fld)[1]() == 10);
+    CHECK(source->loads == 6);
+}
+
+TEST_CASE("modified containers are not released") {
+    auto source = std::make_shared<CountingSource>(3);
+    Record<Layer> layer;
+    layer("values"_fld).setLazySource(source);
+
+    layer("values"_fld)[0] = 5;
+    CHECK(layer.compact() == 0);
+    CHECK(layer("values"_fld)[0]() == 5);
+
+    layer("values"_fld).setLazySource(source);
+    layer("values"_fld).addElement(1);
+    CHECK(layer.compact() == 0);
+    CHECK(layer("values"_fld).size() == 4);
+}
+
+TEST_CASE("copies share the source") {
+    auto source = std::make_shared<CountingSource>(3);
+    Array<int32_t> array;
+    array.setLazySource(source);
+
+    Array<int32_t> copy(array);
+    CHECK_FALSE(copy.isLoaded());
+    CHECK(copy == array);
+    CHECK(source->loads == 0);
+
+    CHECK(copy[1]() == 10);
+    CHECK_FALSE(array.isLoaded());
+}
+
+TEST_CASE("lazy snapshot loading") {
+    Record<Scene> scene;
+    scene("layers"_fld).addElement(Layer{});
+    scene("layers"_fld)[0]("values"_fld).addElement(42);
+    scene("tags"_fld).addElement("answer", 42);
+
+    auto const bytes = writeSnapshot(scene);
+
+    Record<Scene> loaded;
+    REQUIRE(loadSnapshot(bytes, loaded, SnapshotLoading::lazy));
+    CHECK_FALSE(loaded("layers"_fld).isLoaded());
+    CHECK_FALSE(loaded("tags"_fld).isLoaded());
+    CHECK(loaded("layers"_fld).size() == 1);
+    CHECK(loaded("tags"_fld).contains("answer"));
+
+    auto const& values = loaded("layers"_fld)[0]("values"_fld);
+    CHECK(loaded("layers"_fld).isLoaded());
+    CHECK_FALSE(values.isLoaded());
+    CHECK(values[0]() == 42);
+    CHECK(loaded("tags"_fld)["answer"]() == 42);
+}
+
+} // TEST_SUITE("Lazy containers")
+
+//=============================================================================
+// Diff tests
+//=============================================================================
+
+TEST_SUITE("Diff") {
+
+namespace
+{
+Record<Scene> makeScene()
+{
+    Record<Scene> scene;
+    scene("layers"_fld).addElement(Layer{});
+    scene("layers"_fld)[0]("values"_fld).addElement(1);
+    scene("layers"_fld)[0]("values"_fld).addElement(2);
+    scene("tags"_fld).addElement("a", 1);
+    scene("tags"_fld).addElement("b", 2);
+    return scene;
+}
+} // namespace
+
+TEST_CASE("identical records produce no changes") {
+    Record<State> a, b;
+    CHECK(diff(a, b).empty());
+    CHECK(diff(makeScene(), makeScene()).empty());
+}
+
+TEST_CASE("changed leaves are reported by path") {
+    Record<State> a, b;
+    b("line"_fld)("finish"_fld)("y"_fld) = 2.0f;
+    b("count"_fld) = 7;
+
+    auto const changes = diff(a, b);
+    REQUIRE(changes.size() == 2);
+
+    CHECK(changes[0].path == ID::fromString("line/finish/y"));
+    CHECK(changes[0].operation == Object::Operation::modify);
+    CHECK(static_cast<Fundamental<float> const&>(*changes[0].value)() == 2.0f);
+
+    CHECK(changes[1].path == ID::fromString("count"));
+    CHECK(static_cast<Fundamental<int32_t> const&>(*changes[1].value)() == 7);
+}
+
+TEST_CASE("container elements are added, removed and diffed in place") {
+    auto a = makeScene();
+    auto b = makeScene();
+    b("layers"_fld)[0]("values"_fld)[1] = 20;
+    b("layers"_fld)[0]("values"_fld).addElement(3);
+    b("layers"_fld).addElement(Layer{});
+    b("tags"_fld).removeElement("a");
+    b("tags"_fld).addElement("c", 3);
+
+    auto const changes = diff(a, b);
+    REQUIRE(changes.size() == 5);
+
+    CHECK(changes[0].path == ID::fromString("layers/0/values/1"));
+    CHECK(changes[0].operation == Object::Operation::modify);
+    CHECK(changes[1].path == ID::fromString("layers/0/values/2"));
+    CHECK(changes[1].operation == Object::Operation::add);
+    CHECK(changes[2].path == ID::fromString("layers/1"));
+    CHECK(changes[2].operation == Object::Operation::add);
+    CHECK(changes[3].path == ID::fromString("tags/a"));
+    CHECK(changes[3].operation == Object::Operation::remove);
+    CHECK(changes[3].value == nullptr);
+    CHECK(changes[4].path == ID::fromString("tags/c"));
+    CHECK(changes[4].operation == Object::Operation::add);
+}
+
+TEST_CASE("shrinking arrays removes elements from the back") {
+    auto a = makeScene();
+    a("layers"_fld)[0]("values"_fld).addElement(3);
+    auto b = makeScene();
+    b("layers"_fld)[0]("values"_fld).removeElement(1);
+
+    auto const changes = diff(a, b);
+    REQUIRE(changes.size() == 2);
+    CHECK(changes[0].path == ID::fromString("layers/0/values/2"));
+    CHECK(changes[1].path == ID::fromString("layers/0/values/1"));
+    CHECK(changes[1].operation == Object::Operation::remove);
+}
+
+TEST_CASE("applyDiff turns from into to") {
+    auto a = makeScene();
+    auto b = makeScene();
+    b("layers"_fld)[0]("values"_fld).removeElement(0);
+    b("layers"_fld).addElement(Layer{});
+    b("layers"_fld)[1]("values"_fld).addElement(9);
+    b("tags"_fld)["b"] = 4;
+    b("tags"_fld).addElement("z", 26);
+
+    int callCount = 0;
+    auto token = a.addChildListener([&callCount] (ID const&, Object::Operation, Object const&, Value const&) { ++callCount; });
+
+    auto const changes = diff(a, b);
+    CHECK(applyDiff(a, changes));
+    CHECK(a == b);
+    CHECK(callCount == static_cast<int>(changes.size()));
+    CHECK(diff(a, b).empty());
+}
+
+TEST_CASE("hashed diffs skip subtrees with equal hashes") {
+    auto a = makeScene();
+    auto b = makeScene();
+    CHECK(diff(a, b, DiffMode::hashed).empty());
+
+    b("tags"_fld)["b"] = 3;
+    auto const changes = diff(a, b, DiffMode::hashed);
+    REQUIRE(changes.size() == 1);
+    CHECK(changes[0].path == ID::fromString("tags/b"));
+}
+
+TEST_CASE("leaves without operator== are always reported as changed") {
+    struct Channel {
+        Field<Gain, "gain"> gain;
+        Field<int32_t, "index"> index;
+    };
+
+    Record<Channel> a, b;
+    CHECK_FALSE(a == b);
+
+    for (auto const mode : { DiffMode::exact, DiffMode::hashed })
+    {
+        auto const changes = diff(a, b, mode);
+        REQUIRE(changes.size() == 1);
+        CHECK(changes[0].path == ID::fromString("gain"));
+    }
+}
+
+TEST_CASE("applyDiff fails on paths which do not exist") {
+    Record<Scene> scene;
+    std::vector<Change> changes;
+    changes.push_back({ ID::fromString("layers/3/values/0"), Object::Operation::modify, std::make_unique<Fundamental<int32_t>>(1) });
+    CHECK_FALSE(applyDiff(scene, changes));
+}
+
+} // TEST_SUITE("Diff")
+
+//=============================================================================
+// Content hash tests
+//=============================================================================
+
+TEST_SUITE("Content hash") {
+
+TEST_CASE("equal values hash equal") {
+    Record<State> a, b;
+    a("name"_fld) = std::string("x");
+    b("name"_fld) = std::string("x");
+    CHECK(a.contentHash() == b.contentHash());
+
+    Fundamental<float> pz(0.0f), nz(-0.0f);
+    CHECK(pz.contentHash() == nz.contentHash());
+    CHECK(Fundamental<std::string>("ab").contentHash() != Fundamental<std::string>("ba").contentHash());
+}
+
+TEST_CASE("nested changes update the hashes of all ancestors") {
+    Record<Scene> scene;
+    scene("layers"_fld).addElement(Layer{});
+    scene("layers"_fld)[0]("values"_fld).addElement(1);
+
+    auto const sceneHash = scene.contentHash();
+    auto const layersHash = scene("layers"_fld).contentHash();
+    auto const tagsHash = scene("tags"_fld).contentHash();
+
+    scene("layers"_fld)[0]("values"_fld)[0] = 2;
+    CHECK(scene.contentHash() != sceneHash);
+    CHECK(scene("layers"_fld).contentHash() != layersHash);
+    CHECK(scene("tags"_fld).contentHash() == tagsHash);
+
+    scene("layers"_fld)[0]("values"_fld)[0] = 1;
+    CHECK(scene.contentHash() == sceneHash);
+}
+
+TEST_CASE("changes without listener notification invalidate the hash") {
+    Record<Line> line;
+    auto const before = line.contentHash();
+
+    Point start;
+    start.x = 1.0f;
+    start.y = 2.0f;
+
+    Line newLine;
+    newLine.start = start;
+
+    line.set(newLine);
+    CHECK(line.contentHash() != before);
+    CHECK(line("start"_fld).contentHash() == Record<Point>(start).contentHash());
+}
+
+TEST_CASE("map hashes depend on keys") {
+    Map<int32_t> a, b;
+    a.addElement("x", 1);
+    b.addElement("y", 1);
+    CHECK(a.contentHash() != b.contentHash());
+
+    b.removeElement("y");
+    b.addElement("x", 1);
+    CHECK(a.contentHash() == b.contentHash());
+}
+
+TEST_CASE("cached hashes short-cut container equality") {
+    Array<int32_t> a, b;
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        a.addElement(i);
+        b.addElement(i);
+    }
+
+    CHECK(a.contentHash() == b.contentHash());
+    CHECK(a == b);
+
+    b[50] = -1;
+    CHECK(a.contentHash() != b.contentHash());
+    CHECK_FALSE(a == b);
+}
+
+TEST_CASE("equal hashes do not imply equality") {
+    Array<double> a, b;
+    a.addElement(std::numeric_limits<double>::quiet_NaN());
+    b.addElement(std::numeric_limits<double>::quiet_NaN());
+    CHECK_FALSE(a == b);
+
+    // NaNs hash equal, but the cached hashes must not change the result
+    CHECK(a.contentHash() == b.contentHash());
+    CHECK_FALSE(a == b);
+}
+
+TEST_CASE("records and their elements compare field by field") {
+    Record<Quote> a, b;
+    CHECK(a == b);
+
+    b("ask"_fld) = 2.0;
+    CHECK_FALSE(a == b);
+
+    Map<Quote> am, bm;
+    am.addElement("AAPL", a());
+    bm.addElement("AAPL", b());
+    CHECK_FALSE(am == bm);
+}
+
+} // TEST_SUITE("Content hash")
+
+//=============================================================================
+// Version tests
+//=============================================================================
+
+TEST_SUITE("Versions") {
+
+namespace
+{
+std::vector<std::string> changedPaths(Object const& root, std::uint64_t since)
+{
+    std::vector<std::string> paths;
+
+    for (auto const& [path, value] : root.changedSince(since))
+        paths.push_back(path.toString());
+
+    return paths;
+}
+} // namespace
+
+TEST_CASE("changes stamp values and their ancestors") {
+    Record<State> state;
+    CHECK(state.subtreeVersion() == 0);
+
+    state("count"_fld) = 1;
+    CHECK(state("count"_fld).version() == 1);
+    CHECK(state.subtreeVersion() == 1);
+
+    state("line"_fld)("start"_fld)("x"_fld) = 2.0f;
+    CHECK(state("line"_fld)("start"_fld)("x"_fld).version() == 2);
+    CHECK(state("line"_fld).subtreeVersion() == 2);
+    CHECK(state("line"_fld)("finish"_fld).subtreeVersion() == 0);
+    CHECK(state("count"_fld).version() == 1);
+    CHECK(state.subtreeVersion() == 2);
+}
+
+TEST_CASE("changedSince visits only values changed after the version") {
+    Record<State> state;
+    state("count"_fld) = 1;
+    auto const published = state.subtreeVersion();
+
+    state("line"_fld)("finish"_fld)("y"_fld) = 3.0f;
+    state("name"_fld) = std::string("x");
+
+    CHECK(changedPaths(state, published) == std::vector<std::string>{ "line/finish/y", "name" });
+    CHECK(changedPaths(state, 0) == std::vector<std::string>{ "line/finish/y", "count", "name" });
+    CHECK(changedPaths(state, state.subtreeVersion()).empty());
+}
+
+TEST_CASE("container additions and removals") {
+    Record<Scene> scene;
+    scene("tags"_fld).addElement("a", 1);
+    scene("tags"_fld).addElement("b", 2);
+    auto const published = scene.subtreeVersion();
+
+    scene("tags"_fld).removeElement("a");
+    CHECK(changedPaths(scene, published) == std::vector<std::string>{ "tags" });
+
+    auto const afterRemove = scene.subtreeVersion();
+    scene("layers"_fld).addElement(Layer{});
+    CHECK(changedPaths(scene, afterRemove) == std::vector<std::string>{ "layers", "layers/0" });
+}
+
+TEST_CASE("unchanged subtrees are not visited") {
+    Record<Scene> scene;
+    scene("layers"_fld).addElement(Layer{});
+    scene("layers"_fld)[0]("values"_fld).addElement(1);
+    auto const published = scene.subtreeVersion();
+
+    scene("tags"_fld).addElement("a", 1);
+
+    std::size_t visited = 0;
+    for (auto const& entry : scene.changedSince(published))
+    {
+        CHECK(entry.path[0] == "tags");
+        ++visited;
+    }
+
+    CHECK(visited == 2);
+}
+
+TEST_CASE("stamps survive element relocation") {
+    Record<Scene> scene;
+    scene("layers"_fld).addElement(Layer{});
+    scene("layers"_fld)[0]("values"_fld).addElement(1);
+    auto const published = scene.subtreeVersion();
+
+    scene("layers"_fld)[0]("values"_fld)[0] = 2;
+
+    // force the layers to be relocated
+    for (int i = 0; i < 64; ++i)
+        scene("layers"_fld).addElement(Layer{});
+
+    auto const paths = changedPaths(scene, published);
+    CHECK(std::find(paths.begin(), paths.end(), "layers/0/values/0") != paths.end());
+}
+
+TEST_CASE("copies start at version 0") {
+    Record<State> state;
+    state("count"_fld) = 1;
+
+    Record<State> copy(state);
+    CHECK(copy.subtreeVersion() == 0);
+    CHECK(copy("count"_fld).version() == 0);
+}
+
+} // TEST_SUITE("Versions")
+
+//=============================================================================
+// Parallel copy tests
+//=============================================================================
+
+TEST_SUITE("Parallel copy") {
+
+TEST_CASE("task groups run all tasks") {
+    ThreadPool pool(4);
+    std::atomic<int> count = 0;
+
+    {
+        ThreadPool::TaskGroup group(pool);
+
+        for (int i = 0; i < 100; ++i)
+            group.run([&count, &group]
+            {
+                ++count;
+                group.run([&count] { ++count; });
+            });
+
+        group.wait();
+    }
+
+    CHECK(count == 200);
+}
+
+TEST_CASE("copies large trees") {
+    Record<Scene> scene;
+
+    for (int32_t i = 0; i < 50; ++i)
+    {
+        scene("layers"_fld).addElement(Layer{});
+
+        for (int32_t j = 0; j < 20; ++j)
+            scene("layers"_fld)[static_cast<std::size_t>(i)]("values"_fld).addElement(i * j);
+
+        scene("tags"_fld).addElement("tag" + std::to_string(i), i);
+    }
+
+    ThreadPool pool(4);
+    auto const copy = parallelCopy(scene, pool, 8);
+
+    CHECK(copy == Record<Scene>(scene));
+    CHECK(copy("layers"_fld)[49]("values"_fld)[19]() == 49 * 19);
+    CHECK(copy("tags"_fld)["tag7"]() == 7);
+    CHECK(copy.subtreeVersion() == 0);
+}
+
+TEST_CASE("copies have their own parents and listeners") {
+    Record<Scene> scene;
+    scene("layers"_fld).addElement(Layer{});
+    scene("layers"_fld)[0]("values"_fld).addElement(1);
+
+    int originalCount = 0;
+    auto originalToken = scene.addChildListener([&originalCount] (ID const&, Object::Operation, Object const&, Value const&) { ++originalCount; });
+
+    ThreadPool pool(2);
+    auto copy = parallelCopy(scene, pool, 1);
+
+    ID changedPath;
+    auto copyToken = copy.addChildListener([&changedPath] (ID const& path, Object::Operation, Object const&, Value const&) { changedPath = path; });
+
+    copy("layers"_fld)[0]("values"_fld)[0] = 5;
+    CHECK(changedPath == ID::fromString("layers/0/values/0"));
+    CHECK(originalCount == 0);
+    CHECK(scene("layers"_fld)[0]("values"_fld)[0]() == 1);
+}
+
+TEST_CASE("copies members which are not fields") {
+    Record<Mixed> mixed;
+    mixed->tag = 3;
+    mixed->note = "note";
+    mixed("items"_fld).addElement(4);
+
+    ThreadPool pool(2);
+    auto const copy = parallelCopy(mixed, pool);
+
+    CHECK(copy->tag == 3);
+    CHECK(copy->note == "note");
+    CHECK(copy("items"_fld)[0]() == 4);
+}
+
+namespace
+{
+struct WithDefaults
+{
+    Field<Array<int32_t>, "values"> values = []
+    {
+        Field<Array<int32_t>, "values"> defaults;
+        defaults.addElement(1);
+        defaults.addElement(2);
+        return defaults;
+    }();
+
+    Field<Line, "line"> line;
+};
+} // namespace
+
+TEST_CASE("default elements of the copy are replaced") {
+    Record<WithDefaults> source;
+    source("values"_fld).removeElement(0);
+    source("line"_fld)("finish"_fld)("x"_fld) = 3.0f;
+
+    // grain size 1: the fields are copied in separate tasks
+    ThreadPool pool(2);
+    auto const copy = parallelCopy(source, pool, 1);
+
+    REQUIRE(copy("values"_fld).size() == 1);
+    CHECK(copy("values"_fld)[0]() == 2);
+    CHECK(copy("line"_fld)("finish"_fld)("x"_fld)() == 3.0f);
+    CHECK(copy == Record<WithDefaults>(source));
+}
+
+} // TEST_SUITE("Parallel copy")
+
+//=============================================================================
+// Parallel visit tests
+//=============================================================================
+
+TEST_SUITE("Parallel visit") {
+
+TEST_CASE("fieldAt matches typeErasedFields") {
+    Record<Scene> scene;
+    scene("layers"_fld).addElement(Layer{});
+    scene("layers"_fld).addElement(Layer{});
+    scene("tags"_fld).addElement("a", 1);
+
+    for (Object const* object : { static_cast<Object const*>(&scene),
+                                  static_cast<Object const*>(&scene("layers"_fld)),
+                                  static_cast<Object const*>(&scene("tags"_fld)) })
+    {
+        auto const fields = object->typeErasedFields();
+        REQUIRE(object->fieldCount() == fields.size());
+
+        for (std::size_t idx = 0; idx < fields.size(); ++idx)
+            CHECK(&object->fieldAt(idx) == &fields[idx].get());
+
+        CHECK(! object->fieldAt(fields.size()).isValid());
+    }
+}
+
+TEST_CASE("visits every leaf once") {
+    Record<Scene> scene;
+    int64_t expectedSum = 0;
+
+    for (int32_t i = 0; i < 40; ++i)
+    {
+        scene("layers"_fld).addElement(Layer{});
+
+        for (int32_t j = 0; j < 25; ++j)
+        {
+            scene("layers"_fld)[static_cast<std::size_t>(i)]("values"_fld).addElement(i + j);
+            expectedSum += i + j;
+        }
+
+        scene("tags"_fld).addElement("tag" + std::to_string(i), i);
+        expectedSum += i;
+    }
+
+    ThreadPool pool(4);
+    std::atomic<int64_t> sum = 0;
+    std::atomic<int> count = 0;
+
+    parallelVisitLeaves(scene, [&sum, &count] (Value const& leaf)
+    {
+        leaf.visit([&sum] (int32_t x) { sum += x; });
+        ++count;
+    }, pool, 8);
+
+    CHECK(count == 40 * 25 + 40);
+    CHECK(sum == expectedSum);
+}
+
+TEST_CASE("builds leaf paths on request") {
+    Record<Scene> scene;
+
+    for (int32_t i = 0; i < 3; ++i)
+    {
+        scene("layers"_fld).addElement(Layer{});
+        scene("layers"_fld)[static_cast<std::size_t>(i)]("values"_fld).addElement(i);
+    }
+
+    scene("tags"_fld).addElement("answer", 42);
+
+    ThreadPool pool(2);
+    std::mutex mutex;
+    std::vector<std::string> paths;
+
+    parallelVisitLeaves(scene, [&mutex, &paths] (Value const&, LeafPath const& path)
+    {
+        auto id = path.id().toString();
+        std::lock_guard lock(mutex);
+        paths.push_back(std::move(id));
+    }, pool, 1);
+
+    std::sort(paths.begin(), paths.end());
+    CHECK(paths == std::vector<std::string> { "layers/0/values/0", "layers/1/values/0", "layers/2/values/0", "tags/answer" });
+}
+
+} // TEST_SUITE("Parallel visit")
+
+//=============================================================================
+// Concurrent map tests
+//=============================================================================
+
+TEST_SUITE("Concurrent map") {
+
+TEST_CASE("behaves like a map") {
+    ConcurrentMap<int32_t, 4> map;
+    map.insertOrAssign("a", 1);
+    map.insertOrAssign("b", 2);
+    map.insertOrAssign("a", 3);
+
+    CHECK(map.size() == 2);
+    CHECK(map.contains("a"));
+    CHECK(! map.contains("c"));
+
+    int32_t value = 0;
+    CHECK(map.read("a", [&value] (Fundamental<int32_t> const& element) { value = element(); }));
+    CHECK(value == 3);
+
+    CHECK(map.update("b", [] (Fundamental<int32_t>& element) { element = element() * 10; }));
+    CHECK(map.read("b", [&value] (Fundamental<int32_t> const& element) { value = element(); }));
+    CHECK(value == 20);
+    // fields are listed shard after shard
+    auto const bIndex = map.shardOf("b") < map.shardOf("a") ? 0 : 1;
+    CHECK(&static_cast<Object&>(map)("b") == &map.fieldAt(bIndex));
+    CHECK(! map.update("c", [] (Fundamental<int32_t>&) {}));
+
+    CHECK(map.removeElement("a"));
+    CHECK(! map.removeElement("a"));
+    CHECK(map.size() == 1);
+    CHECK(map.fieldCount() == 1);
+}
+
+TEST_CASE("notifies parents with map paths") {
+    Record<Market> market;
+
+    std::vector<std::pair<std::string, Object::Operation>> changes;
+    auto token = market.addChildListener([&changes] (ID const& path, Object::Operation op, Object const&, Value const&)
+    {
+        changes.emplace_back(path.toString(), op);
+    });
+
+    Quote quote;
+    quote.bid = 1.0;
+    market("quotes"_fld).insertOrAssign("AAPL", quote);
+    market("quotes"_fld).update("AAPL", [] (Record<Quote>& q) { q("ask"_fld) = 2.0; });
+    market("quotes"_fld).removeElement("AAPL");
+
+    REQUIRE(changes.size() == 3);
+    CHECK(changes[0] == std::make_pair(std::string("quotes/AAPL"), Object::Operation::add));
+    CHECK(changes[1] == std::make_pair(std::string("quotes/AAPL/ask"), Object::Operation::modify));
+    CHECK(changes[2] == std::make_pair(std::string("quotes/AAPL"), Object::Operation::remove));
+}
+
+TEST_CASE("stamps changes with versions of the tree") {
+    Record<Market> market;
+    market("open"_fld) = true;
+    market("quotes"_fld).insertOrAssign("AAPL", Quote{});
+
+    auto const published = market.subtreeVersion();
+    market("quotes"_fld).update("AAPL", [] (Record<Quote>& q) { q("bid"_fld) = 5.0; });
+    CHECK(market.subtreeVersion() > published);
+
+    std::vector<std::string> paths;
+    for (auto const& [path, value] : market.changedSince(published))
+        paths.push_back(path.toString());
+
+    CHECK(paths == std::vector<std::string> { "quotes/AAPL/bid" });
+}
+
+TEST_CASE("concurrent writers") {
+    static constexpr int kThreads = 8;
+    static constexpr int kKeysPerThread = 50;
+    static constexpr int kUpdates = 20;
+
+    Record<Market> market;
+
+    // listeners are called one at a time
+    std::map<std::string, double> lastBid;
+    int notifications = 0;
+    bool ordered = true;
+
+    auto token = market.addChildListener([&] (ID const& path, Object::Operation op, Object const&, Value const& value)
+    {
+        ++notifications;
+
+        if (op != Object::Operation::modify || path.back() != "bid")
+            return;
+
+        auto const bid = static_cast<Fundamental<double> const&>(value)();
+        auto& last = lastBid[path[1]];
+        ordered = ordered && bid > last;
+        last = bid;
+    });
+
+    std::vector<std::thread> writers;
+
+    for (int t = 0; t < kThreads; ++t)
+    {
+        writers.emplace_back([&market, t]
+        {
+            for (int k = 0; k < kKeysPerThread; ++k)
+                market("quotes"_fld).insertOrAssign("key" + std::to_string(t * kKeysPerThread + k), Quote{});
+
+            for (int u = 1; u <= kUpdates; ++u)
+                for (int k = 0; k < kKeysPerThread; ++k)
+                    market("quotes"_fld).update("key" + std::to_string(t * kKeysPerThread + k),
+                                                [u] (Record<Quote>& q) { q("bid"_fld) = static_cast<double>(u); });
+        });
+    }
+
+    for (auto& writer : writers)
+        writer.join();
+
+    CHECK(market("quotes"_fld).size() == kThreads * kKeysPerThread);
+    CHECK(notifications == kThreads * kKeysPerThread * (1 + kUpdates));
+    CHECK(ordered);
+
+    double bid = 0.0;
+    market("quotes"_fld).read("key7", [&bid] (Record<Quote> const& q) { bid = q("bid"_fld)(); });
+    CHECK(bid == kUpdates);
+}
+
+TEST_CASE("copies and compares") {
+    Record<Market> market;
+    market("quotes"_fld).insertOrAssign("AAPL", Quote{});
+
+    Record<Market> copy(market);
+    CHECK(copy("quotes"_fld) == market("quotes"_fld));
+    CHECK(copy("quotes"_fld).contentHash() == market("quotes"_fld).contentHash());
+
+    copy("quotes"_fld).update("AAPL", [] (Record<Quote>& q) { q("bid"_fld) = 1.0; });
+    CHECK(! (copy("quotes"_fld) == market("quotes"_fld)));
+    CHECK(market("quotes"_fld).metaType().isMap());
+    CHECK(market("quotes"_fld).metaType().schemaHash() != Map<Quote>::meta().schemaHash());
+}
+
+TEST_CASE("is copied in parallel and diffed shard by shard") {
+    Record<Market> market;
+
+    for (int i = 0; i < 32; ++i)
+    {
+        Quote quote;
+        quote.bid = static_cast<double>(i);
+        market("quotes"_fld).insertOrAssign("Q" + std::to_string(i), quote);
+    }
+
+    ThreadPool pool(2);
+    auto copy = parallelCopy(market, pool, 1);
+    CHECK(copy == market);
+    CHECK(diff(market, copy).empty());
+
+    copy("quotes"_fld).update("Q7", [] (Record<Quote>& q) { q("ask"_fld) = 1.0; });
+    copy("quotes"_fld).removeElement("Q9");
+    copy("quotes"_fld).insertOrAssign("Q99", Quote{});
+
+    for (auto const mode : { DiffMode::exact, DiffMode::hashed })
+    {
+        std::vector<std::string> paths;
+        for (auto const& change : diff(market, copy, mode))
+            paths.push_back(change.path.toString());
+
+        std::sort(paths.begin(), paths.end());
+        CHECK(paths == std::vector<std::string> { "quotes/Q7/ask", "quotes/Q9", "quotes/Q99" });
+    }
+
+    auto const changes = diff(market, copy);
+    CHECK(applyDiff(market, changes));
+    CHECK(market == copy);
+}
+
+} // TEST_SUITE("Concurrent map")
+
+//=============================================================================
+// Concurrent reads tests
+//=============================================================================
+
+TEST_SUITE("Concurrent reads") {
+
+TEST_CASE("load returns the value written by any writer path") {
+    Record<Quote> quote;
+    quote("bid"_fld) = 1.5;
+    CHECK(quote("bid"_fld).load() == 1.5);
+
+    quote("bid"_fld).mutate([] (double& bid) { bid += 1.0; });
+    CHECK(quote("bid"_fld).load() == 2.5);
+
+    static_cast<Value&>(quote("ask"_fld)).visit([] (double& ask) { ask = 4.0; });
+    CHECK(quote("ask"_fld).load() == 4.0);
+
+    Fundamental<Symbol> symbol;
+    Symbol aapl;
+    std::memcpy(aapl.chars.data(), "AAPL", 4);
+    symbol = aapl;
+    CHECK(symbol.load() == aapl);
+
+    static_assert(Fundamental<double>::kConcurrentReads);
+    static_assert(! Fundamental<std::string>::kConcurrentReads);
+}
+
+TEST_CASE("listeners run as before") {
+    Fundamental<FixedPrice> price;
+    int calls = 0;
+    auto token = price.addListener([&calls] (Fundamental<FixedPrice> const&) { ++calls; });
+
+    price = FixedPrice{ 10 };
+    price = FixedPrice{ 10 };
+    static_cast<Value&>(price).visit([] (FixedPrice& p) { p.ticks = 11; });
+
+    CHECK(calls == 2);
+    CHECK(price.load() == FixedPrice{ 11 });
+}
+
+TEST_CASE("readers never observe torn values") {
+    static constexpr int kNumWrites = 20000;
+
+    Fundamental<Symbol> symbol;
+    std::atomic<bool> done = false;
+    std::atomic<int> torn = 0;
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i)
+    {
+        readers.emplace_back([&symbol, &done, &torn]
+        {
+            while (! done.load())
+            {
+                auto const s = symbol.load();
+                if (std::any_of(s.chars.begin(), s.chars.end(), [&s] (char c) { return c != s.chars[0]; }))
+                    ++torn;
+            }
+        });
+    }
+
+    for (int i = 1; i <= kNumWrites; ++i)
+    {
+        Symbol s;
+        s.chars.fill(static_cast<char>(i % 100));
+        symbol = s;
+    }
+
+    done = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    CHECK(torn.load() == 0);
+    CHECK(symbol.load().chars[15] == static_cast<char>(kNumWrites % 100));
+}
+
+} // TEST_SUITE("Concurrent reads")
+
+//=============================================================================
+// Change stream tests
+//=============================================================================
+
+namespace
+{
+// Fire-and-forget coroutine which starts eagerly
+struct Task
+{
+    struct promise_type
+    {
+        Task get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+Task collect(ChangeStream& stream, std::vector<Change>& out, std::size_t count)
+{
+    while (out.size() < count)
+    {
+        auto change = co_await stream.next();
+
+        if (! change)
+            break;
+
+        out.push_back(std::move(*change));
+    }
+}
+
+float floatValue(Change const& change) { return static_cast<Fundamental<float> const&>(*change.value)(); }
+} // namespace
+
+TEST_SUITE("Change stream") {
+
+TEST_CASE("yields the changes of a subtree in order") {
+    Record<Line> line;
+    ChangeStream stream(line);
+    std::vector<Change> changes;
+    collect(stream, changes, 3);
+
+    line("start"_fld)("x"_fld) = 1.0f;
+    line("finish"_fld)("y"_fld) = 2.0f;
+    line("start"_fld)("x"_fld) = 3.0f;
+
+    REQUIRE(changes.size() == 3);
+    CHECK(changes[0].path.toString() == "start/x");
+    CHECK(changes[1].path.toString() == "finish/y");
+    CHECK(changes[2].operation == Object::Operation::modify);
+    CHECK(floatValue(changes[2]) == 3.0f);
+}
+
+TEST_CASE("buffers changes and drops them on overflow") {
+    Fundamental<float> leaf;
+    auto stream = changes(leaf, { .capacity = 2, .overflow = ChangeStream::Overflow::drop });
+
+    leaf = 1.0f;
+    leaf = 2.0f;
+    leaf = 3.0f;
+    CHECK(stream.dropped() == 1);
+
+    std::vector<Change> changes;
+    collect(stream, changes, 2);
+
+    REQUIRE(changes.size() == 2);
+    CHECK(changes[0].path.empty());
+    CHECK(floatValue(changes[1]) == 2.0f);
+}
+
+TEST_CASE("coalesces changes of the same path") {
+    Record<Point> point;
+    ChangeStream stream(point, { .capacity = 4, .overflow = ChangeStream::Overflow::coalesce });
+
+    point("x"_fld) = 1.0f;
+    point("y"_fld) = 2.0f;
+    point("x"_fld) = 3.0f;
+
+    std::vector<Change> changes;
+    collect(stream, changes, 2);
+
+    REQUIRE(changes.size() == 2);
+    CHECK(changes[0].path.toString() == "x");
+    CHECK(floatValue(changes[0]) == 3.0f);
+    CHECK(changes[1].path.toString() == "y");
+    CHECK(stream.dropped() == 0);
+}
+
+TEST_CASE("does not coalesce across removals and changes of ancestors") {
+    Map<int32_t> map;
+    ChangeStream stream(map, { .capacity = 8, .overflow = ChangeStream::Overflow::coalesce });
+
+    map.addElement("x", 1);
+    map.removeElement("x");
+    map.addElement("x", 2);
+    map["x"] = 3;
+
+    std::vector<Change> changes;
+    collect(stream, changes, 3);
+
+    REQUIRE(changes.size() == 3);
+    CHECK(changes[0].operation == Object::Operation::add);
+    CHECK(changes[1].operation == Object::Operation::remove);
+    CHECK(changes[2].operation == Object::Operation::add);
+    CHECK(static_cast<Fundamental<int32_t> const&>(*changes[2].value)() == 3);
+}
+
+TEST_CASE("resumes the consumer on the executor and ends when closed") {
+    Record<Point> point;
+    std::vector<std::coroutine_handle<>> queued;
+    ChangeStream stream(point, { .executor = [&queued] (std::coroutine_handle<> h) { queued.push_back(h); } });
+
+    std::vector<Change> changes;
+    collect(stream, changes, 3);
+
+    point("x"_fld) = 1.0f;
+    CHECK(changes.empty());
+    REQUIRE(queued.size() == 1);
+    std::exchange(queued, {}).front().resume();
+    CHECK(changes.size() == 1);
+
+    stream.close();
+    REQUIRE(queued.size() == 1);
+    queued.front().resume();
+    CHECK(changes.size() == 1);
+}
+
+TEST_CASE("blocks the writer until the consumer made room") {
+    Record<Point> point;
+    ChangeStream stream(point, { .capacity = 1, .overflow = ChangeStream::Overflow::block });
+
+    std::thread writer([&point]
+    {
+        for (int i = 1; i <= 3; ++i)
+            point("x"_fld) = static_cast<float>(i);
+    });
+
+    std::vector<Change> changes;
+    collect(stream, changes, 3);
+    writer.join();
+
+    REQUIRE(changes.size() == 3);
+    CHECK(floatValue(changes[0]) == 1.0f);
+    CHECK(floatValue(changes[2]) == 3.0f);
+    CHECK(stream.dropped() == 0);
+}
+
+} // TEST_SUITE("Change stream")
+
+//=============================================================================
+// Event ring tests
+//=============================================================================
+
+namespace
+{
+// counts the global heap allocations of each thread
+thread_local std::size_t heapAllocations = 0;
+}
+
+void* operator new(std::size_t size)
+{
+    ++heapAllocations;
+
+    if (auto* p = std::malloc(size != 0 ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+TEST_SUITE("Event ring") {
+
+TEST_CASE("captures paths, operations and small values") {
+    Record<Scene> scene;
+    EventRing ring(scene, 16);
+
+    scene("layers"_fld).addElement(Layer{});
+    scene("layers"_fld)[0]("values"_fld).addElement(5);
+    scene("layers"_fld)[0]("values"_fld)[0] = 7;
+    scene("layers"_fld).removeElement(0);
+
+    std::vector<RingEvent> events;
+    CHECK(ring.drain([&events] (RingEvent const& event) { events.push_back(event); }) == 4);
+
+    REQUIRE(events.size() == 4);
+    CHECK(ring.path(events[0].path).toString() == "layers/0");
+    CHECK(events[0].operation == Object::Operation::add);
+    CHECK(! events[0].type);
+    CHECK(ring.path(events[1].path).toString() == "layers/0/values/0");
+    CHECK(events[1].path == events[2].path);
+    CHECK(events[1].value<int32_t>() == 5);
+    CHECK(events[2].operation == Object::Operation::modify);
+    CHECK(events[2].value<int32_t>() == 7);
+    CHECK(! events[2].value<int64_t>());
+    CHECK(events[3].operation == Object::Operation::remove);
+    CHECK(! events[3].type);
+
+    CHECK(ring.drain([] (RingEvent const&) {}) == 0);
+    CHECK(ring.highWaterMark() == 4);
+}
+
+TEST_CASE("does not allocate for changes of a known path") {
+    Record<Scene> scene;
+    scene("layers"_fld).addElement(Layer{});
+    scene("layers"_fld)[0]("values"_fld).addElement(5);
+
+    EventRing ring(scene, 64);
+    auto& value = scene("layers"_fld)[0]("values"_fld)[0];
+
+    // the first change interns the path
+    value = 6;
+    auto const before = heapAllocations;
+
+    for (int i = 7; i < 17; ++i)
+        value = i;
+
+    CHECK(heapAllocations == before);
+
+    std::vector<RingEvent> events;
+    CHECK(ring.drain([&events] (RingEvent const& event) { events.push_back(event); }) == 11);
+    CHECK(std::ranges::all_of(events, [&] (RingEvent const& event) { return event.path == events.front().path; }));
+    CHECK(ring.path(events.front().path).toString() == "layers/0/values/0");
+
+    // the paths stay right when the elements move in memory
+    for (int i = 0; i < 8; ++i)
+        scene("layers"_fld).addElement(Layer{});
+
+    scene("layers"_fld)[8]("values"_fld).addElement(1);
+    scene("layers"_fld)[0]("values"_fld)[0] = 2;
+
+    events.clear();
+    ring.drain([&events] (RingEvent const& event) { events.push_back(event); });
+
+    REQUIRE(events.size() == 10);
+    CHECK(ring.path(events[8].path).toString() == "layers/8/values/0");
+    CHECK(ring.path(events[9].path).toString() == "layers/0/values/0");
+}
+
+TEST_CASE("drops events when full and drains in batches") {
+    Record<Point> point;
+    EventRing ring(point, 4);
+
+    for (int i = 1; i <= 6; ++i)
+        point("x"_fld) = static_cast<float>(i);
+
+    CHECK(ring.capacity() == 4);
+    CHECK(ring.dropped() == 2);
+
+    std::vector<float> values;
+    auto const collect = [&values] (RingEvent const& event) { values.push_back(*event.value<float>()); };
+    CHECK(ring.drain(collect, 3) == 3);
+    CHECK(ring.drain(collect) == 1);
+    CHECK(values == std::vector<float>{ 1.0f, 2.0f, 3.0f, 4.0f });
+
+    point("x"_fld) = 7.0f;
+    CHECK(ring.drain(collect) == 1);
+    CHECK(values.back() == 7.0f);
+}
+
+TEST_CASE("delivers changes of several writer threads") {
+    static constexpr int kNumThreads = 4;
+    static constexpr int kUpdatesPerThread = 2000;
+
+    Record<Market> market;
+    for (int t = 0; t < kNumThreads; ++t)
+        market("quotes"_fld).insertOrAssign("SYM" + std::to_string(t), Quote{});
+
+    EventRing ring(market, 256);
+    std::atomic<int> running = kNumThreads;
+    std::vector<std::thread> writers;
+
+    for (int t = 0; t < kNumThreads; ++t)
+    {
+        writers.emplace_back([&market, &running, t]
+        {
+            for (int u = 1; u <= kUpdatesPerThread; ++u)
+                market("quotes"_fld).update("SYM" + std::to_string(t), [u] (Record<Quote>& q) { q("bid"_fld) = u; });
+
+            --running;
+        });
+    }
+
+    std::map<std::string, double> last;
+    std::size_t received = 0;
+    auto const consume = [&] (RingEvent const& event)
+    {
+        auto const bid = event.value<double>();
+        REQUIRE(bid);
+        auto& previous = last[ring.path(event.path).toString()];
+        CHECK(*bid > previous);
+        previous = *bid;
+        ++received;
+    };
+
+    while (running.load() > 0)
+        ring.drain(consume);
+
+    for (auto& writer : writers)
+        writer.join();
+
+    ring.drain(consume);
+
+    CHECK(received + ring.dropped() == static_cast<std::size_t>(kNumThreads * kUpdatesPerThread));
+    // all updates of a writer may be dropped while the consumer is not scheduled
+    CHECK((last.size() == kNumThreads || ring.dropped() > 0));
+    CHECK(ring.highWaterMark() <= ring.capacity());
+}
+
+} // TEST_SUITE("Event ring")
+
+//=============================================================================
+// Memory resource tests
+//=============================================================================
+
+namespace
+{
+struct CountingResource : std::pmr::memory_resource
+{
+    std::size_t allocations = 0;
+    std::size_t outstanding = 0;
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations;
+        ++outstanding;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        --outstanding;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const& o) const noexcept override { return this == &o; }
+};
+} // namespace
+
+TEST_SUITE("Memory resource") {
+
+TEST_CASE("MemoryResourceScope selects and restores the current resource") {
+    CountingResource outer, inner;
+    CHECK(MemoryResourceScope::current() == std::pmr::get_default_resource());
+    {
+        MemoryResourceScope outerScope(&outer);
+        CHECK(MemoryResourceScope::current() == &outer);
+        {
+            MemoryResourceScope innerScope(&inner);
+            CHECK(MemoryResourceScope::current() == &inner);
+        }
+        CHECK(MemoryResourceScope::current() == &outer);
+
+        Array<int32_t> arr;
+        CHECK(arr.resource() == &outer);
+    }
+    CHECK(MemoryResourceScope::current() == std::pmr::get_default_resource());
+}
+
+TEST_CASE("Record with memory resource allocates nested containers from it") {
+    CountingResource resource;
+    {
+        Record<Scene> scene(&resource);
+        CHECK(scene("layers"_fld).resource() == &resource);
+        CHECK(scene("tags"_fld).resource() == &resource);
+
+        scene("layers"_fld).addElement(Layer{});
+        scene("layers"_fld).addElement(Layer{});
+        scene("tags"_fld).addElement("a", 1);
+
+        auto& values = scene("layers"_fld)[1]("values"_fld);
+        CHECK(values.resource() == &resource);
+        values.addElement(42);
+        CHECK(values[0]() == 42);
+
+        CHECK(resource.allocations >= 4);
+        CHECK(resource.outstanding > 0);
+
+        // the resource is only active during construction
+        CHECK(MemoryResourceScope::current() == std::pmr::get_default_resource());
+    }
+    CHECK(resource.outstanding == 0);
+}
+
+TEST_CASE("copies allocate from the current resource") {
+    CountingResource resource;
+    Record<Scene> scene(&resource);
+    scene("layers"_fld).addElement(Layer{});
+
+    Record<Scene> copy(scene);
+    CHECK(copy("layers"_fld).resource() == std::pmr::get_default_resource());
+    CHECK(copy("layers"_fld)[0]("values"_fld).resource() == std::pmr::get_default_resource());
+
+    // assignment keeps the recipient's resource
+    scene = copy;
+    CHECK(scene("layers"_fld).resource() == &resource);
+    CHECK(scene("layers"_fld)[0]("values"_fld).resource() == &resource);
+}
+
+TEST_CASE("monotonic arena") {
+    std::pmr::monotonic_buffer_resource arena;
+    Record<Scene> scene(&arena);
+
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        Layer layer;
+        layer.values.addElement(i);
+        scene("layers"_fld).addElement(layer);
+    }
+
+    CHECK(scene("layers"_fld).size() == 100);
+    CHECK(scene("layers"_fld)[99]("values"_fld)[0]() == 99);
+    CHECK(scene("layers"_fld)[50]("values"_fld).resource() == &arena);
+}
+
+} // TEST_SUITE("Memory resource")
+
+//=============================================================================
+// Stream and format output tests
+//=============================================================================
+
+TEST_SUITE("Stream output") {
+
+TEST_CASE("Value stream output") {
+    Fundamental<int32_t> val(42);
+    std::ostringstream ss;
+    ss << static_cast<Value const&>(val);
+    CHECK(ss.str() == "42");
+}
+
+TEST_CASE("Object stream output") {
+    Record<Point> point;
+    point("x"_fld) = 1.0f;
+    point("y"_fld) = 2.0f;
+    std::ostringstream ss;
+    ss << static_cast<Object const&>(point);
+    std::string result = ss.str();
+    CHECK(result.find(".x = ") != std::string::npos);
+    CHECK(result.find(".y = ") != std::string::npos);
+}
+
+TEST_CASE("std::format with Value") {
+    Fundamental<int32_t> val(123);
+    CHECK(std::format("{}", static_cast<Value const&>(val)) == "123");
+}
+
+TEST_CASE("std::format with Object") {
+    Record<Point> point;
+    point("x"_fld) = 1.0f;
+    point("y"_fld) = 2.0f;
+    auto result = std::format("{}", static_cast<Object const&>(point));
+    CHECK(result.find(".x = ") != std::string::npos);
+}
+
+TEST_CASE("std::format with ID") {
+    auto id = ID::fromString("a/b/c");
+    CHECK(std::format("{}", id) == "a/b/c");
+}
+
+TEST_CASE("bool stream output") {
+    Fundamental<bool> val;
     val = true;
     std::ostringstream ss;
     ss << static_cast<Value const&>(val);
@@ -1464,6 +3678,128 @@ TEST_CASE("metaTypeOf returns singletons") {
     CHECK(&a == &b);
 }
 
+TEST_CASE("field descriptor offsets match the struct layout") {
+    auto offsetOf = [] (auto const& object, auto const& member)
+    {
+        return static_cast<std::size_t>(reinterpret_cast<char const*>(&member) - reinterpret_cast<char const*>(&object));
+    };
+
+    State state;
+    auto const& stateFields = metaTypeOf<State>().fields();
+    REQUIRE(stateFields.size() == 4);
+    CHECK(stateFields[0].offset == offsetOf(state, state.line));
+    CHECK(stateFields[1].offset == offsetOf(state, state.count));
+    CHECK(stateFields[2].offset == offsetOf(state, state.name));
+    CHECK(stateFields[3].offset == offsetOf(state, state.active));
+
+    // non-Field members are skipped but still accounted for in the layout
+    Mixed mixed;
+    auto const& mixedFields = metaTypeOf<Mixed>().fields();
+    REQUIRE(mixedFields.size() == 4);
+    CHECK(mixedFields[0].offset == offsetOf(mixed, mixed.value));
+    CHECK(mixedFields[1].offset == offsetOf(mixed, mixed.flag));
+    CHECK(mixedFields[2].offset == offsetOf(mixed, mixed.items));
+    CHECK(mixedFields[3].offset == offsetOf(mixed, mixed.point));
+
+    // over-aligned members do not follow the natural alignment of their type
+    Aligned aligned;
+    auto const& alignedFields = metaTypeOf<Aligned>().fields();
+    REQUIRE(alignedFields.size() == 2);
+    CHECK(alignedFields[1].offset == offsetOf(aligned, aligned.wide));
+    CHECK(alignedFields[1].offset % 64 == 0);
+
+    CHECK(mixedFields[0].size == sizeof(double));
+    CHECK(mixedFields[1].size == sizeof(bool));
+    CHECK(mixedFields[2].size == sizeof(Array<int32_t>));
+    CHECK(mixedFields[3].size == sizeof(Point));
+}
+
+TEST_CASE("field descriptor accessors") {
+    Record<Mixed> record;
+    void* object = record.operator->();
+    auto const& fields = Record<Mixed>::meta().fields();
+
+    CHECK(&fields[0].field(object) == static_cast<Value*>(&record("value"_fld)));
+    CHECK(fields[3].constField(static_cast<void const*>(object)).fieldname() == "point");
+
+    int callCount = 0;
+    auto token = record.addChildListener([&callCount] (ID const&, Object::Operation, Object const&, Value const&) { ++callCount; });
+
+    double const newValue = 2.5;
+    fields[0].set(object, &newValue);
+    CHECK(record("value"_fld)() == 2.5);
+    CHECK(callCount == 1);
+
+    double readBack = 0.0;
+    fields[0].get(object, &readBack);
+    CHECK(readBack == 2.5);
+
+    Point const point{ {}, {} };
+    Point pointReadBack;
+    fields[3].set(object, &point);
+    fields[3].get(object, &pointReadBack);
+    CHECK(pointReadBack.x() == 0.0f);
+
+    Array<int32_t> items;
+    items.addElement(7);
+    fields[2].set(object, &items);
+    CHECK(record("items"_fld).size() == 1);
+
+    Array<int32_t> itemsReadBack;
+    fields[2].get(object, &itemsReadBack);
+    CHECK(itemsReadBack.size() == 1);
+    CHECK(itemsReadBack[0]() == 7);
+}
+
+TEST_CASE("type names") {
+    CHECK(metaTypeOf<int32_t>().name() == "int32");
+    CHECK(metaTypeOf<uint64_t>().name() == "uint64");
+    CHECK(metaTypeOf<std::string>().name() == "string");
+    CHECK(metaTypeOf<Array<int32_t>>().name() == "Array<int32>");
+    CHECK(metaTypeOf<Map<bool>>().name() == "Map<bool>");
+    CHECK(metaTypeOf<Array<Telemetry>>().name() == "Array<test.Telemetry>");
+    CHECK(metaTypeOf<Telemetry>().name() == "test.Telemetry");
+    CHECK(metaTypeOf<Point>().name().ends_with("Point"));
+    CHECK(Value::kInvalid.metaType().name() == "invalid");
+}
+
+TEST_CASE("schema hash is structural") {
+    static_assert(detail::SchemaHash<Point>::value == detail::SchemaHash<PointCopy>::value);
+    static_assert(detail::SchemaHash<Point>::value != detail::SchemaHash<PointRenamed>::value);
+    static_assert(detail::SchemaHash<Point>::value != detail::SchemaHash<PointRetyped>::value);
+    static_assert(detail::SchemaHash<Array<int32_t>>::value != detail::SchemaHash<Map<int32_t>>::value);
+    static_assert(detail::SchemaHash<Array<int32_t>>::value != detail::SchemaHash<int32_t>::value);
+
+    CHECK(metaTypeOf<Line>().schemaHash() == detail::SchemaHash<Line>::value);
+    CHECK(metaTypeOf<Line>().schemaHash() != metaTypeOf<Point>().schemaHash());
+}
+
+TEST_CASE("registry lookup by name") {
+    auto const* meta = MetaTypeRegistry::findByName("test.Telemetry");
+    REQUIRE(meta != nullptr);
+    CHECK(meta == &metaTypeOf<Telemetry>());
+
+    auto value = meta->construct();
+    REQUIRE(value != nullptr);
+    CHECK(value->type() == typeid(Telemetry));
+
+    CHECK(MetaTypeRegistry::findByName("test.DoesNotExist") == nullptr);
+}
+
+TEST_CASE("registry lookup by schema hash") {
+    auto const* meta = MetaTypeRegistry::findBySchemaHash(metaTypeOf<Scene>().schemaHash());
+    REQUIRE(meta != nullptr);
+    CHECK(meta->typeInfo() == typeid(Scene));
+    CHECK(MetaTypeRegistry::findBySchemaHash(0) == nullptr);
+}
+
+TEST_CASE("records register themselves") {
+    auto const all = MetaTypeRegistry::registered();
+    CHECK(std::ranges::find(all, &metaTypeOf<Layer>()) != all.end());
+    CHECK(std::ranges::find(all, &metaTypeOf<Telemetry>()) != all.end());
+    CHECK(std::ranges::all_of(all, [] (MetaType const* meta) { return meta->isRecord(); }));
+}
+
 } // TEST_SUITE("MetaType")
 
 //=============================================================================
@@ -1494,6 +3830,163 @@ TEST_CASE("field type info") {
     CHECK(point("x"_fld).type() == typeid(float));
 }
 
+TEST_CASE("compile-time field name") {
+    static_assert(Field<float, "width">::kFieldName == "width");
+    static_assert(decltype(Rect::area)::kFieldName == "area");
+}
+
+TEST_CASE("field hooks run before listeners") {
+    Record<Rect> rect;
+    std::vector<float> areasSeenByListener;
+
+    auto token = rect.addChildListener([&] (ID const& path, Object::Operation, Object const&, Value const&) {
+        if (path.toString() == "width")
+            areasSeenByListener.push_back(rect("area"_fld)());
+    });
+
+    rect("height"_fld) = 3.0f;
+    rect("width"_fld) = 2.0f;
+    CHECK(rect("area"_fld)() == 6.0f);
+    CHECK(areasSeenByListener == std::vector<float>{ 6.0f });
+
+    rect("width"_fld).mutate([] (float& w) { w *= 2.0f; });
+    CHECK(rect("area"_fld)() == 12.0f);
+
+    // unchanged values do not run the hooks
+    auto const calls = UpdateArea::calls;
+    rect("width"_fld) = 4.0f;
+    CHECK(UpdateArea::calls == calls);
+}
+
+TEST_CASE("field hooks run for type-erased and record assignments") {
+    Record<Rect> rect;
+
+    CHECK(static_cast<Object&>(rect).getchild(ID::fromString("width")).assign(Fundamental<float>(5.0f)));
+    rect("height"_fld) = 2.0f;
+    CHECK(rect("area"_fld)() == 10.0f);
+
+    int notifications = 0;
+    auto token = rect.addListener([&notifications] (auto const&) { ++notifications; });
+
+    // the fields' notifications are suppressed, their hooks run once all fields are stored
+    Rect other;
+    other.width = 1.0f;
+    other.height = 7.0f;
+    other.area = 0.0f;
+    rect = other;
+
+    CHECK(rect("area"_fld)() == 7.0f);
+    CHECK(notifications == 1);
+}
+
+TEST_CASE("field hooks run for writes through visit and assignChild") {
+    Record<Rect> rect;
+    rect("height"_fld) = 3.0f;
+
+    static_cast<Value&>(rect("width"_fld)).visit([] (float& width) { width = 2.0f; });
+    CHECK(rect("area"_fld)() == 6.0f);
+
+    CHECK(static_cast<Object&>(rect).assignChild("height", Fundamental<float>(5.0f)));
+    CHECK(rect("area"_fld)() == 10.0f);
+
+    // typed writes call the hooks directly, type-erased writes through the record: either way once
+    auto const calls = UpdateArea::calls;
+    rect("width"_fld) = 4.0f;
+    CHECK(UpdateArea::calls == calls + 1);
+    static_cast<Value&>(rect("width"_fld)).visit([] (float& width) { width = 1.0f; });
+    CHECK(UpdateArea::calls == calls + 2);
+    CHECK(rect("area"_fld)() == 5.0f);
+}
+
+TEST_CASE("computed fields are recomputed when a dependency changed") {
+    Record<Span> span;
+    Width::evaluations = 0;
+
+    // writing a dependency only marks the value as out of date, reading computes it
+    span("finish"_fld)("x"_fld) = 5.0f;
+    CHECK(Width::evaluations == 0);
+    CHECK(span("width"_fld)() == 5.0f);
+    CHECK(Width::evaluations == 1);
+
+    // neither reading nor changing an unrelated field recomputes
+    span("label"_fld) = std::string("span");
+    CHECK(span("width"_fld)() == 5.0f);
+    CHECK(Width::evaluations == 1);
+
+    // type-erased reads see the new value
+    span("start"_fld)("x"_fld) = 2.0f;
+    float visited = 0.0f;
+    static_cast<Object const&>(span)("width").visit([&visited] (float const& v) { visited = v; });
+    CHECK(visited == 3.0f);
+
+    // a record assignment computes once, after all fields are stored
+    Width::evaluations = 0;
+    Span other;
+    other.finish = Point{};
+    span.set(other);
+    CHECK(span("width"_fld)() == 0.0f);
+    CHECK(Width::evaluations == 1);
+}
+
+TEST_CASE("computed fields are evaluated once after a burst of writes") {
+    Record<Span> span;
+    Width::evaluations = 0;
+
+    for (auto i = 1; i <= 100; ++i)
+    {
+        span("start"_fld)("x"_fld) = static_cast<float>(i);
+        span("finish"_fld)("x"_fld) = static_cast<float>(3 * i);
+    }
+
+    CHECK(Width::evaluations == 0);
+    CHECK(static_cast<float>(span("width"_fld)) == 200.0f);
+    CHECK(span("width"_fld)() == 200.0f);
+    CHECK(Width::evaluations == 1);
+
+    // reads through the record and the encoders compute as well
+    span("start"_fld)("x"_fld) = 0.0f;
+    CHECK(static_cast<Object const&>(span).fieldAt(3).contentHash() == Fundamental<float>(300.0f).contentHash());
+    CHECK(Width::evaluations == 2);
+
+    span("finish"_fld)("x"_fld) = 10.0f;
+    auto const bytes = encode(span);
+    CHECK(Width::evaluations == 3);
+
+    Record<Span> decoded;
+    CHECK(decode(bytes, decoded));
+    CHECK(decoded("width"_fld)() == 10.0f);
+}
+
+TEST_CASE("computed fields take part in listeners and reflection like fields") {
+    Record<Span> span;
+    std::vector<std::string> paths;
+
+    auto token = span.addChildListener([&paths] (ID const& path, Object::Operation, Object const&, Value const&) {
+        paths.push_back(path.toString());
+    });
+
+    // a write of a dependency is only notified as such, but changedSince() reports the computed field
+    auto const before = span.subtreeVersion();
+    span("finish"_fld)("x"_fld) = 4.0f;
+    CHECK(paths == std::vector<std::string>{ "finish/x" });
+
+    std::vector<std::string> changed;
+
+    for (auto const& [path, value] : span.changedSince(before))
+        changed.push_back(path.toString());
+
+    CHECK(std::ranges::find(changed, "width") != changed.end());
+
+    CHECK(Record<Span>::kFieldNames[3] == "width");
+    CHECK(Record<Span>::meta().fields()[3].metaType().typeInfo() == typeid(float));
+
+    // copies compute their own value
+    Record<Span> copy(span);
+    copy("start"_fld)("x"_fld) = 1.0f;
+    CHECK(copy("width"_fld)() == 3.0f);
+    CHECK(span("width"_fld)() == 4.0f);
+}
+
 } // TEST_SUITE("Field")
 
 //=============================================================================
@@ -0,0 +1,41 @@
+#pragma once
+
+// Leaf types registered with dynamic::ExtraFundamentalTypes for the unit tests.
+// Included by dynamic.hpp via DYNAMIC_EXTRA_FUNDAMENTAL_TYPES_HEADER (see CMakeLists.txt).
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <tuple>
+
+struct FixedPrice {
+    int64_t ticks = 0;
+    bool operator==(FixedPrice const&) const = default;
+};
+
+inline std::ostream& operator<<(std::ostream& o, FixedPrice const& p) { return o << p.ticks << "t"; }
+
+struct Symbol {
+    std::array<char, 16> chars = {};
+    bool operator==(Symbol const&) const = default;
+};
+
+inline std::ostream& operator<<(std::ostream& o, Symbol const& s) { return o << s.chars.data(); }
+
+// A leaf without operator== (and without a unique object representation)
+struct Gain {
+    double decibels = 0.0;
+};
+
+inline std::ostream& operator<<(std::ostream& o, Gain const& g) { return o << g.decibels << "dB"; }
+
+template <>
+struct dynamic::ExtraFundamentalTypes<>
+{
+    using Types = std::tuple<std::chrono::nanoseconds, Symbol, FixedPrice, Gain>;
+};
+
+// FixedPrice fits into an atomic, Symbol is read through a sequence lock
+template <> struct dynamic::ConcurrentReads<FixedPrice> : std::true_type {};
+template <> struct dynamic::ConcurrentReads<Symbol> : std::true_type {};
@@ -0,0 +1,630 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "dynamic.hpp"
+
+namespace dynamic
+{
+
+/**
+ * @brief Binary encodings for exchanging Records between processes
+ *
+ * Both encodings start with a WireHeader carrying Record<T>::kSchemaHash of the
+ * sender. Values are stored in native byte order; a receiver with a different
+ * byte order rejects the message.
+ */
+enum class WireEncoding : std::uint16_t
+{
+    /// Values only, in field order. Smallest and fastest, but only decodable by a receiver with the same schema hash
+    positional = 0,
+
+    /// Every value is tagged with its kind, schema hash and size, record fields with their name.
+    /// Decodable by receivers with a different schema: fields are matched by name, unknown fields
+    /// and fields whose leaf type changed are skipped.
+    tagged = 1
+};
+
+/// Header at the start of every encoded message
+struct WireHeader
+{
+    static constexpr std::uint32_t kMagic = 0x5759'4e44; // "DNYW" in little-endian byte order
+    static constexpr std::uint16_t kVersion = 1;
+
+    std::uint32_t magic = kMagic;
+    std::uint16_t version = kVersion;
+    WireEncoding encoding = WireEncoding::positional;
+    std::uint64_t schemaHash = 0;
+};
+
+static_assert(sizeof(WireHeader) == 16 && std::is_trivially_copyable_v<WireHeader>);
+
+/**
+ * @brief Encodes record into a message
+ *
+ * Leaf types other than std::string and ID must be trivially copyable.
+ */
+template <typename T>
+std::vector<std::byte> encode(Record<T> const& record, WireEncoding encoding = WireEncoding::positional);
+
+/**
+ * @brief Decodes a message produced by encode() into record
+ *
+ * If the message's schema hash equals Record<T>::kSchemaHash, values are copied
+ * positionally without looking at field names. Otherwise the message must use
+ * WireEncoding::tagged and fields are matched by name. record is only assigned
+ * after the whole message was decoded successfully. The assignment notifies like
+ * Record<T>::set(): changed leaf fields are reported as a single change of the
+ * record, while Array and Map fields notify the removal and addition of each
+ * of their elements.
+ *
+ * Leaves are copied byte-wise, except for bool and enum leaves which are
+ * validated (a bool must be 0 or 1). Trivially copyable leaf structs holding
+ * bools or enums are not validated and should only be decoded from trusted
+ * senders.
+ *
+ * @return False if the message is malformed, has a foreign byte order or version,
+ *         or is positionally encoded with a different schema. record is left
+ *         unchanged in that case.
+ */
+template <typename T>
+bool decode(std::span<std::byte const> message, Record<T>& record);
+
+/// Returns the header of message, or nullopt if message does not start with a valid header
+inline std::optional<WireHeader> peekWireHeader(std::span<std::byte const> message)
+{
+    WireHeader header;
+
+    if (message.size() < sizeof(header))
+        return std::nullopt;
+
+    std::memcpy(&header, message.data(), sizeof(header));
+
+    if (header.magic != WireHeader::kMagic || header.version != WireHeader::kVersion)
+        return std::nullopt;
+
+    if (header.encoding != WireEncoding::positional && header.encoding != WireEncoding::tagged)
+        return std::nullopt;
+
+    return header;
+}
+
+//=============================================================================
+// Implementation details
+//=============================================================================
+namespace detail::wire
+{
+
+enum class Kind : std::uint8_t { leaf, record, array, map };
+
+class Writer
+{
+public:
+    void bytes(void const* data, std::size_t size)
+    {
+        auto const* begin = static_cast<std::byte const*>(data);
+        buffer.insert(buffer.end(), begin, begin + size);
+    }
+
+    template <typename T>
+    void raw(T const& value) { bytes(&value, sizeof(T)); }
+
+    void string(std::string_view str)
+    {
+        raw(static_cast<std::uint32_t>(str.size()));
+        bytes(str.data(), str.size());
+    }
+
+    /// Writes a placeholder for the size of the data following it, see endSized()
+    std::size_t beginSized()
+    {
+        raw(std::uint32_t{});
+        return buffer.size();
+    }
+
+    void endSized(std::size_t start)
+    {
+        auto const size = static_cast<std::uint32_t>(buffer.size() - start);
+        std::memcpy(buffer.data() + start - sizeof(size), &size, sizeof(size));
+    }
+
+    std::vector<std::byte> buffer;
+};
+
+class Reader
+{
+public:
+    explicit Reader(std::span<std::byte const> data_) : data(data_) {}
+
+    bool bytes(void* out, std::size_t size)
+    {
+        if (size > data.size())
+            return false;
+
+        if (size > 0)
+            std::memcpy(out, data.data(), size);
+
+        data = data.subspan(size);
+        return true;
+    }
+
+    template <typename T>
+    bool raw(T& value) { return bytes(&value, sizeof(T)); }
+
+    bool string(std::string& str)
+    {
+        std::uint32_t size = 0;
+
+        if (! raw(size) || size > data.size())
+            return false;
+
+        str.assign(reinterpret_cast<char const*>(data.data()), size);
+        data = data.subspan(size);
+        return true;
+    }
+
+    /// Splits off the next size bytes into their own Reader
+    std::optional<Reader> sized()
+    {
+        std::uint32_t size = 0;
+
+        if (! raw(size) || size > data.size())
+            return std::nullopt;
+
+        Reader result(data.first(size));
+        data = data.subspan(size);
+        return result;
+    }
+
+    bool atEnd() const { return data.empty(); }
+
+private:
+    std::span<std::byte const> data;
+};
+
+template <typename T>
+struct Codec;
+
+template <typename T>
+void writeValue(Writer& writer, typename Codec<T>::Wrapper const& value, WireEncoding encoding);
+
+template <typename T>
+bool readTaggedValue(Reader& reader, typename Codec<T>::Wrapper& value);
+
+bool skipTaggedValue(Reader& reader);
+
+/**
+ * @brief Encoder/decoder for values of type T
+ *
+ * Operates on the reflection wrapper of T (Fundamental<T>, Record<T> or the
+ * container itself), i.e. on fields and container elements alike.
+ */
+template <typename T>
+struct Codec
+{
+    using Wrapper = BaseTypeFor<T>;
+    static constexpr auto kKind = Value::isOpaque<T>() ? Kind::leaf : Kind::record;
+
+    static void write(Writer& writer, Wrapper const& value, WireEncoding encoding)
+    {
+        if constexpr (kKind == Kind::leaf)
+        {
+            writeLeaf(writer, value());
+        }
+        else
+        {
+            if (encoding == WireEncoding::tagged)
+                writer.raw(static_cast<std::uint32_t>(Record<T>::kFieldNames.size()));
+
+            std::apply([&] (auto const&... fields)
+            {
+                std::size_t idx = 0;
+
+                (std::invoke([&] (auto const& field)
+                {
+                    if (encoding == WireEncoding::tagged)
+                        writer.string(Record<T>::kFieldNames[idx]);
+
+                    writeField(writer, field, encoding);
+                    ++idx;
+                }, fields), ...);
+            }, value.fields());
+        }
+    }
+
+    static bool readPositional(Reader& reader, Wrapper& value)
+    {
+        if constexpr (kKind == Kind::leaf)
+        {
+            T leaf;
+
+            if (! readLeaf(reader, leaf))
+                return false;
+
+            value.set(std::move(leaf));
+            return true;
+        }
+        else
+        {
+            return std::apply([&reader] (auto&... fields)
+            {
+                return (readFieldPositional(reader, fields) && ...);
+            }, value.fields());
+        }
+    }
+
+    /// Reads a tagged payload (without the kind/hash/size prefix, see readTaggedValue)
+    static bool readTagged(Reader& reader, Wrapper& value)
+    {
+        if constexpr (kKind == Kind::leaf)
+        {
+            return readPositional(reader, value);
+        }
+        else
+        {
+            std::uint32_t count = 0;
+
+            if (! reader.raw(count))
+                return false;
+
+            std::string name;
+
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                if (! reader.string(name))
+                    return false;
+
+                bool ok = true;
+                auto const found = std::apply([&] (auto&... fields)
+                {
+                    std::size_t idx = 0;
+                    bool matched = false;
+
+                    (std::invoke([&] (auto& field)
+                    {
+                        if (! matched && Record<T>::kFieldNames[idx] == name)
+                        {
+                            matched = true;
+                            ok = readFieldTagged(reader, field);
+                        }
+
+                        ++idx;
+                    }, fields), ...);
+
+                    return matched;
+                }, value.fields());
+
+                if (! found)
+                    ok = skipTaggedValue(reader);
+
+                if (! ok)
+                    return false;
+            }
+
+            return true;
+        }
+    }
+
+private:
+    template <typename U>
+    static void writeLeaf(Writer& writer, U const& leaf)
+    {
+        if constexpr (std::is_same_v<U, std::string>)
+        {
+            writer.string(leaf);
+        }
+        else if constexpr (std::is_same_v<U, ID>)
+        {
+            writer.raw(static_cast<std::uint32_t>(leaf.size()));
+
+            for (auto const& element : leaf)
+                writer.string(element);
+        }
+        else
+        {
+            static_assert(std::is_trivially_copyable_v<U>, "Leaf types must be trivially copyable to be encoded");
+            writer.raw(leaf);
+        }
+    }
+
+    template <typename U>
+    static bool readLeaf(Reader& reader, U& leaf)
+    {
+        if constexpr (std::is_same_v<U, std::string>)
+        {
+            return reader.string(leaf);
+        }
+        else if constexpr (std::is_same_v<U, ID>)
+        {
+            std::uint32_t count = 0;
+
+            if (! reader.raw(count))
+                return false;
+
+            leaf.clear();
+
+            for (std::uint32_t i = 0; i < count; ++i)
+                if (! reader.string(leaf.emplace_back()))
+                    return false;
+
+            return true;
+        }
+        else
+        {
+            // the message is untrusted: copying it into a bool or enum directly could create an invalid value
+            std::array<std::byte, sizeof(U)> bytes;
+            return reader.bytes(bytes.data(), bytes.size()) && leaf_from_bytes(bytes.data(), leaf);
+        }
+    }
+
+    template <typename F>
+    static void writeField(Writer& writer, F const& field, WireEncoding encoding);
+
+    template <typename F>
+    static bool readFieldPositional(Reader& reader, F& field);
+
+    template <typename F>
+    static bool readFieldTagged(Reader& reader, F& field);
+};
+
+template <typename T>
+struct Codec<Array<T>>
+{
+    using Wrapper = Array<T>;
+    static constexpr auto kKind = Kind::array;
+
+    static void write(Writer& writer, Wrapper const& array, WireEncoding encoding);
+    static bool readPositional(Reader& reader, Wrapper& array);
+    static bool readTagged(Reader& reader, Wrapper& array);
+};
+
+template <typename T>
+struct Codec<Map<T>>
+{
+    using Wrapper = Map<T>;
+    static constexpr auto kKind = Kind::map;
+
+    static void write(Writer& writer, Wrapper const& map, WireEncoding encoding);
+    static bool readPositional(Reader& reader, Wrapper& map);
+    static bool readTagged(Reader& reader, Wrapper& map);
+};
+
+/// Writes value in the encoding, tagged values are prefixed with their kind, schema hash and size
+template <typename T>
+void writeValue(Writer& writer, typename Codec<T>::Wrapper const& value, WireEncoding encoding)
+{
+    if (encoding == WireEncoding::positional)
+    {
+        Codec<T>::write(writer, value, encoding);
+        return;
+    }
+
+    writer.raw(Codec<T>::kKind);
+    writer.raw(SchemaHash<T>::value);
+
+    auto const start = writer.beginSized();
+    Codec<T>::write(writer, value, encoding);
+    writer.endSized(start);
+}
+
+inline bool skipTaggedValue(Reader& reader)
+{
+    Kind kind;
+    std::uint64_t hash = 0;
+    return reader.raw(kind) && reader.raw(hash) && reader.sized().has_value();
+}
+
+/**
+ * @brief Reads a tagged value into value
+ *
+ * Values of a different kind, and leaves of a different type, are skipped and
+ * leave value untouched. Records, arrays and maps are decoded by name
+ * recursively even if their schema differs.
+ */
+template <typename T>
+bool readTaggedValue(Reader& reader, typename Codec<T>::Wrapper& value)
+{
+    Kind kind;
+    std::uint64_t hash = 0;
+
+    if (! reader.raw(kind) || ! reader.raw(hash))
+        return false;
+
+    auto payload = reader.sized();
+
+    if (! payload)
+        return false;
+
+    if (kind != Codec<T>::kKind || (kind == Kind::leaf && hash != SchemaHash<T>::value))
+        return true;
+
+    return Codec<T>::readTagged(*payload, value) && payload->atEnd();
+}
+
+template <typename T>
+template <typename F>
+void Codec<T>::writeField(Writer& writer, F const& field, WireEncoding encoding)
+{
+    writeValue<field_value_type_t<std::remove_cvref_t<F>>>(writer, field, encoding);
+}
+
+template <typename T>
+template <typename F>
+bool Codec<T>::readFieldPositional(Reader& reader, F& field)
+{
+    return Codec<field_value_type_t<std::remove_cvref_t<F>>>::readPositional(reader, field);
+}
+
+template <typename T>
+template <typename F>
+bool Codec<T>::readFieldTagged(Reader& reader, F& field)
+{
+    return readTaggedValue<field_value_type_t<std::remove_cvref_t<F>>>(reader, field);
+}
+
+template <typename T>
+void Codec<Array<T>>::write(Writer& writer, Wrapper const& array, WireEncoding encoding)
+{
+    writer.raw(static_cast<std::uint32_t>(array.size()));
+
+    for (auto const& element : array)
+        writeValue<T>(writer, element, encoding);
+}
+
+template <typename T>
+bool Codec<Array<T>>::readPositional(Reader& reader, Wrapper& array)
+{
+    std::uint32_t count = 0;
+
+    if (! reader.raw(count))
+        return false;
+
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        BaseTypeFor<T> element;
+
+        if (! Codec<T>::readPositional(reader, element))
+            return false;
+
+        array.addElement(element());
+    }
+
+    return true;
+}
+
+template <typename T>
+bool Codec<Array<T>>::readTagged(Reader& reader, Wrapper& array)
+{
+    std::uint32_t count = 0;
+
+    if (! reader.raw(count))
+        return false;
+
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        BaseTypeFor<T> element;
+
+        if (! readTaggedValue<T>(reader, element))
+            return false;
+
+        array.addElement(element());
+    }
+
+    return true;
+}
+
+template <typename T>
+void Codec<Map<T>>::write(Writer& writer, Wrapper const& map, WireEncoding encoding)
+{
+    writer.raw(static_cast<std::uint32_t>(map.size()));
+
+    for (auto const& element : map)
+    {
+        writer.string(element.fieldname());
+        writeValue<T>(writer, element, encoding);
+    }
+}
+
+template <typename T>
+bool Codec<Map<T>>::readPositional(Reader& reader, Wrapper& map)
+{
+    std::uint32_t count = 0;
+
+    if (! reader.raw(count))
+        return false;
+
+    std::string key;
+
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        BaseTypeFor<T> element;
+
+        if (! reader.string(key) || ! Codec<T>::readPositional(reader, element))
+            return false;
+
+        map.addElement(key, element());
+    }
+
+    return true;
+}
+
+template <typename T>
+bool Codec<Map<T>>::readTagged(Reader& reader, Wrapper& map)
+{
+    std::uint32_t count = 0;
+
+    if (! reader.raw(count))
+        return false;
+
+    std::string key;
+
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        BaseTypeFor<T> element;
+
+        if (! reader.string(key) || ! readTaggedValue<T>(reader, element))
+            return false;
+
+        map.addElement(key, element());
+    }
+
+    return true;
+}
+
+} // namespace detail::wire
+
+template <typename T>
+std::vector<std::byte> encode(Record<T> const& record, WireEncoding encoding)
+{
+    detail::wire::Writer writer;
+
+    WireHeader header;
+    header.encoding = encoding;
+    header.schemaHash = Record<T>::kSchemaHash;
+    writer.raw(header);
+
+    if (encoding == WireEncoding::positional)
+        detail::wire::Codec<T>::write(writer, record, encoding);
+    else
+        detail::wire::writeValue<T>(writer, record, encoding);
+
+    return std::move(writer.buffer);
+}
+
+template <typename T>
+bool decode(std::span<std::byte const> message, Record<T>& record)
+{
+    auto const header = peekWireHeader(message);
+
+    if (! header)
+        return false;
+
+    detail::wire::Reader reader(message.subspan(sizeof(WireHeader)));
+    Record<T> decoded;
+
+    if (header->encoding == WireEncoding::positional)
+    {
+        // fast path: identical schema, no names to compare
+        if (header->schemaHash != Record<T>::kSchemaHash || ! detail::wire::Codec<T>::readPositional(reader, decoded))
+            return false;
+    }
+    else
+    {
+        if (! detail::wire::readTaggedValue<T>(reader, decoded))
+            return false;
+    }
+
+    if (! reader.atEnd())
+        return false;
+
+    record.set(decoded());
+    return true;
+}
+
+} // namespace dynamic